@@ -0,0 +1,404 @@
+//
+// benchmark/bitstreams.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark/benchmark.h"
+
+#include <boost/radix/static_ibitstream_lsb.hpp>
+#include <boost/radix/static_ibitstream_msb.hpp>
+#include <boost/radix/static_obitstream_lsb.hpp>
+#include <boost/radix/static_obitstream_msb.hpp>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+#include "../test/common.hpp"
+
+#include <chrono>
+#include <vector>
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Each packer and unpacker on its own, without the alphabet mapping or the
+// encoder and decoder loops around it, for every width. A run covers 4KiB of
+// packed data so everything stays in L1. Results are reported per segment in
+// cycles of the time stamp counter, which runs at the nominal clock rather
+// than the boosted one, and nanoseconds where there isn't one.
+namespace {
+
+using namespace boost::radix;
+
+std::size_t const run_bytes = 4096;
+
+boost::uint64_t read_cycle_counter() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+template <std::size_t Bits>
+struct segment_run {
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      packed_segment_size = bits::to_packed_segment_size<Bits>::value);
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      unpacked_segment_size = bits::to_unpacked_segment_size<Bits>::value);
+  BOOST_STATIC_CONSTANT(
+      std::size_t, segments = run_bytes / packed_segment_size);
+
+  // Slack on the end of both buffers for the vector kernels, which load and
+  // store 16 bytes at a time.
+  segment_run()
+      : packed(generate_random_bytes(segments * packed_segment_size + 16))
+      , symbols(generate_random_bytes(
+            segments * unpacked_segment_size + 16, (1 << Bits) - 1)) {
+  }
+
+  std::vector<bits_type> packed;
+  std::vector<bits_type> symbols;
+};
+
+// Runs kernel over a segment_run each iteration and reports the cost.
+template <std::size_t Bits, typename Kernel>
+void measure(benchmark::State& state, Kernel kernel) {
+  segment_run<Bits> run;
+  boost::uint64_t const start = read_cycle_counter();
+  for(auto _ : state) {
+    kernel(run);
+    benchmark::ClobberMemory();
+  }
+  double const cycles   = double(read_cycle_counter() - start);
+  double const segments = double(state.iterations()) * run.segments;
+  state.counters["cycles_per_segment"] = cycles / segments;
+  state.counters["bytes_per_cycle"] =
+      segments * run.packed_segment_size / cycles;
+  state.SetBytesProcessed(
+      int64_t(state.iterations()) *
+      int64_t(run.segments * run.packed_segment_size));
+}
+
+// -----------------------------------------------------------------------------
+// Kernels taking one segment at a time.
+template <std::size_t Bits, typename SegmentUnpacker>
+struct unpack_each {
+  void operator()(segment_run<Bits>& run) const {
+    bits_type const* packed = run.packed.data();
+    bits_type* symbols      = run.symbols.data();
+    for(std::size_t i = 0; i < run.segments; ++i) {
+      boost::array<bits_type, segment_run<Bits>::unpacked_segment_size>
+          segment;
+      SegmentUnpacker()(packed, segment);
+      symbols = std::copy(segment.begin(), segment.end(), symbols);
+      packed += run.packed_segment_size;
+    }
+  }
+};
+
+template <std::size_t Bits, typename SegmentPacker>
+struct pack_each {
+  void operator()(segment_run<Bits>& run) const {
+    bits_type const* symbols = run.symbols.data();
+    bits_type* packed        = run.packed.data();
+    for(std::size_t i = 0; i < run.segments; ++i) {
+      packed = SegmentPacker()(symbols, packed);
+      symbols += run.unpacked_segment_size;
+    }
+  }
+};
+
+// The scalar code behind the segment packers, named so that the fast paths
+// those pick can be compared against it.
+template <std::size_t Bits>
+struct ladder_unpacker_msb {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    detail::unpack(packed, u, boost::integral_constant<std::size_t, Bits>());
+  }
+};
+
+template <std::size_t Bits>
+struct basic_unpacker_msb {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    detail::unpack_basic(
+        packed, u, boost::integral_constant<std::size_t, Bits>());
+  }
+};
+
+template <std::size_t Bits>
+struct basic_unpacker_lsb {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    detail::unpack_lsb_basic<Bits>(packed, u);
+  }
+};
+
+template <std::size_t Bits>
+struct ladder_packer_msb {
+  bits_type* operator()(bits_type const* symbols, bits_type* packed) const {
+    return detail::pack(
+        symbols, packed, boost::integral_constant<std::size_t, Bits>());
+  }
+};
+
+template <std::size_t Bits>
+struct basic_packer_msb {
+  bits_type* operator()(bits_type const* symbols, bits_type* packed) const {
+    return detail::pack_basic(
+        symbols, packed, boost::integral_constant<std::size_t, Bits>());
+  }
+};
+
+template <std::size_t Bits>
+struct basic_packer_lsb {
+  bits_type* operator()(bits_type const* symbols, bits_type* packed) const {
+    return detail::pack_lsb_basic<Bits>(symbols, packed);
+  }
+};
+
+#if BOOST_RADIX_SIMD_BMI2
+template <std::size_t Bits, bit_order Order>
+struct bmi2_unpacker {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    detail::bmi2_bitstream<Bits, Order>::unpack(packed, u.data());
+  }
+};
+
+template <std::size_t Bits, bit_order Order>
+struct bmi2_packer {
+  bits_type* operator()(bits_type const* symbols, bits_type* packed) const {
+    detail::bmi2_bitstream<Bits, Order>::pack(symbols, packed);
+    return packed + bits::to_packed_segment_size<Bits>::value;
+  }
+};
+#endif
+
+// -----------------------------------------------------------------------------
+// Kernels taking runs of segments: the path the encoder and decoder use, and
+// the vector kernels on their own, including the widths that path leaves to
+// the scalar code.
+template <std::size_t Bits, typename SegmentUnpacker>
+struct unpack_run {
+  void operator()(segment_run<Bits>& run) const {
+    detail::unpack_segments<
+        segment_run<Bits>::packed_segment_size,
+        segment_run<Bits>::unpacked_segment_size>(
+        SegmentUnpacker(), run.packed.data(), run.segments,
+        run.symbols.data());
+  }
+};
+
+template <std::size_t Bits, typename SegmentPacker>
+struct pack_run {
+  void operator()(segment_run<Bits>& run) const {
+    detail::pack_segments<
+        segment_run<Bits>::packed_segment_size,
+        segment_run<Bits>::unpacked_segment_size>(
+        SegmentPacker(), run.symbols.data(), run.segments, run.packed.data());
+  }
+};
+
+#if BOOST_RADIX_SIMD_VECTOR_EXTENSIONS
+template <std::size_t Bits, bit_order Order>
+struct vector_unpack {
+  void operator()(segment_run<Bits>& run) const {
+    typedef detail::vector_bitstream<Bits, Order> stream_type;
+    stream_type const& stream = stream_type::instance();
+    bits_type const* packed   = run.packed.data();
+    bits_type* symbols        = run.symbols.data();
+    for(std::size_t i = 0; i < run.segments / stream_type::block_segments;
+        ++i) {
+      stream.unpack(packed, symbols);
+      packed += stream_type::block_bytes;
+      symbols += stream_type::block_symbols;
+    }
+  }
+};
+
+template <std::size_t Bits, bit_order Order>
+struct vector_pack {
+  void operator()(segment_run<Bits>& run) const {
+    typedef detail::vector_bitstream<Bits, Order> stream_type;
+    stream_type const& stream = stream_type::instance();
+    bits_type const* symbols  = run.symbols.data();
+    bits_type* packed         = run.packed.data();
+    for(std::size_t i = 0; i < run.segments / stream_type::block_segments;
+        ++i) {
+      stream.pack(symbols, packed);
+      symbols += stream_type::block_symbols;
+      packed += stream_type::block_bytes;
+    }
+  }
+};
+#endif
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+#define RADIX_BENCH_WIDTHS(name)                                               \
+  BENCHMARK_TEMPLATE(name, 1);                                                 \
+  BENCHMARK_TEMPLATE(name, 2);                                                 \
+  BENCHMARK_TEMPLATE(name, 3);                                                 \
+  BENCHMARK_TEMPLATE(name, 4);                                                 \
+  BENCHMARK_TEMPLATE(name, 5);                                                 \
+  BENCHMARK_TEMPLATE(name, 6);                                                 \
+  BENCHMARK_TEMPLATE(name, 7)
+
+template <std::size_t Bits>
+static void Unpack_Msb(benchmark::State& state) {
+  measure<Bits>(state, unpack_each<Bits, static_ibitstream_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb);
+
+template <std::size_t Bits>
+static void Unpack_Msb_Ladder(benchmark::State& state) {
+  measure<Bits>(state, unpack_each<Bits, ladder_unpacker_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb_Ladder);
+
+template <std::size_t Bits>
+static void Unpack_Msb_Basic(benchmark::State& state) {
+  measure<Bits>(state, unpack_each<Bits, basic_unpacker_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb_Basic);
+
+template <std::size_t Bits>
+static void Unpack_Lsb(benchmark::State& state) {
+  measure<Bits>(state, unpack_each<Bits, static_ibitstream_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Lsb);
+
+template <std::size_t Bits>
+static void Unpack_Lsb_Basic(benchmark::State& state) {
+  measure<Bits>(state, unpack_each<Bits, basic_unpacker_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Lsb_Basic);
+
+template <std::size_t Bits>
+static void Unpack_Msb_Run(benchmark::State& state) {
+  measure<Bits>(state, unpack_run<Bits, static_ibitstream_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb_Run);
+
+template <std::size_t Bits>
+static void Unpack_Lsb_Run(benchmark::State& state) {
+  measure<Bits>(state, unpack_run<Bits, static_ibitstream_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Lsb_Run);
+
+template <std::size_t Bits>
+static void Pack_Msb(benchmark::State& state) {
+  measure<Bits>(state, pack_each<Bits, static_obitstream_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb);
+
+template <std::size_t Bits>
+static void Pack_Msb_Ladder(benchmark::State& state) {
+  measure<Bits>(state, pack_each<Bits, ladder_packer_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb_Ladder);
+
+template <std::size_t Bits>
+static void Pack_Msb_Basic(benchmark::State& state) {
+  measure<Bits>(state, pack_each<Bits, basic_packer_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb_Basic);
+
+template <std::size_t Bits>
+static void Pack_Lsb(benchmark::State& state) {
+  measure<Bits>(state, pack_each<Bits, static_obitstream_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Lsb);
+
+template <std::size_t Bits>
+static void Pack_Lsb_Basic(benchmark::State& state) {
+  measure<Bits>(state, pack_each<Bits, basic_packer_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Lsb_Basic);
+
+template <std::size_t Bits>
+static void Pack_Msb_Run(benchmark::State& state) {
+  measure<Bits>(state, pack_run<Bits, static_obitstream_msb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb_Run);
+
+template <std::size_t Bits>
+static void Pack_Lsb_Run(benchmark::State& state) {
+  measure<Bits>(state, pack_run<Bits, static_obitstream_lsb<Bits> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Lsb_Run);
+
+#if BOOST_RADIX_SIMD_BMI2
+template <std::size_t Bits>
+static void Unpack_Msb_Bmi2(benchmark::State& state) {
+  measure<Bits>(
+      state, unpack_each<Bits, bmi2_unpacker<Bits, bit_order_msb_first> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb_Bmi2);
+
+template <std::size_t Bits>
+static void Unpack_Lsb_Bmi2(benchmark::State& state) {
+  measure<Bits>(
+      state, unpack_each<Bits, bmi2_unpacker<Bits, bit_order_lsb_first> >());
+}
+RADIX_BENCH_WIDTHS(Unpack_Lsb_Bmi2);
+
+template <std::size_t Bits>
+static void Pack_Msb_Bmi2(benchmark::State& state) {
+  measure<Bits>(
+      state, pack_each<Bits, bmi2_packer<Bits, bit_order_msb_first> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb_Bmi2);
+
+template <std::size_t Bits>
+static void Pack_Lsb_Bmi2(benchmark::State& state) {
+  measure<Bits>(
+      state, pack_each<Bits, bmi2_packer<Bits, bit_order_lsb_first> >());
+}
+RADIX_BENCH_WIDTHS(Pack_Lsb_Bmi2);
+#endif
+
+#if BOOST_RADIX_SIMD_VECTOR_EXTENSIONS
+template <std::size_t Bits>
+static void Unpack_Msb_Vector(benchmark::State& state) {
+  measure<Bits>(state, vector_unpack<Bits, bit_order_msb_first>());
+}
+RADIX_BENCH_WIDTHS(Unpack_Msb_Vector);
+
+template <std::size_t Bits>
+static void Unpack_Lsb_Vector(benchmark::State& state) {
+  measure<Bits>(state, vector_unpack<Bits, bit_order_lsb_first>());
+}
+RADIX_BENCH_WIDTHS(Unpack_Lsb_Vector);
+
+template <std::size_t Bits>
+static void Pack_Msb_Vector(benchmark::State& state) {
+  measure<Bits>(state, vector_pack<Bits, bit_order_msb_first>());
+}
+RADIX_BENCH_WIDTHS(Pack_Msb_Vector);
+
+template <std::size_t Bits>
+static void Pack_Lsb_Vector(benchmark::State& state) {
+  measure<Bits>(state, vector_pack<Bits, bit_order_lsb_first>());
+}
+RADIX_BENCH_WIDTHS(Pack_Lsb_Vector);
+#endif
+
+BENCHMARK_MAIN();
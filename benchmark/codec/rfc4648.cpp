@@ -20,9 +20,6 @@
 
 #include "../test/common.hpp"
 
-#include <boost/radix/static_ibitstream_lsb.hpp>
-#include <boost/radix/static_obitstream_lsb.hpp>
-
 template <typename Iterator>
 auto unwrap_iterator(Iterator i) {
 #if _HAS_ITERATOR_DEBUGGING
@@ -34,65 +31,12 @@ auto unwrap_iterator(Iterator i) {
 
 struct base64_lsb : boost::radix::codec::rfc4648::base64 {};
 
-boost::radix::static_obitstream_lsb<
-    boost::radix::codec_traits::required_bits<base64_lsb>::value>
-get_segment_packer(base64_lsb const&) {
-  return boost::radix::static_obitstream_lsb<
-      boost::radix::codec_traits::required_bits<base64_lsb>::value>();
-}
-
-boost::radix::static_ibitstream_lsb<
-    boost::radix::codec_traits::required_bits<base64_lsb>::value>
-get_segment_unpacker(base64_lsb const&) {
-  return boost::radix::static_ibitstream_lsb<
-      boost::radix::codec_traits::required_bits<base64_lsb>::value>();
-}
-
-// static void Base64_Encode_BackInserter(benchmark::State& state) {
-//  boost::radix::codec::rfc4648::base64 codec;
-//
-//  std::vector<bits_type> data = generate_random_bytes(state.range(0));
-//
-//  for(auto _ : state) {
-//    std::string result;
-//    boost::radix::encode(
-//        data.begin(), data.end(), std::back_inserter(result), codec);
-//  }
-//
-//  state.SetBytesProcessed(
-//      int64_t(state.iterations()) * int64_t(state.range(0)));
-//}
-// BENCHMARK(Base64_Encode_BackInserter)
-//    ->Arg(128)
-//    ->Arg(1024)
-//    ->Arg(8 * 1024)
-//    ->Arg(64 * 1024)
-//    ->Arg(1024 * 1024);
-//
-// static void Base64_Decode_BackInserter(benchmark::State& state) {
-//  boost::radix::codec::rfc4648::base64 codec;
-//
-//  std::vector<bits_type> data = generate_random_bytes(state.range(0));
-//
-//  std::string encoded;
-//  boost::radix::encode(
-//      data.begin(), data.end(), std::back_inserter(encoded), codec);
-//
-//  for(auto _ : state) {
-//    std::vector<bits_type> result;
-//    boost::radix::decode(
-//        encoded.begin(), encoded.end(), std::back_inserter(result), codec);
-//  }
-//
-//  state.SetBytesProcessed(
-//      int64_t(state.iterations()) * int64_t(state.range(0)));
-//}
-// BENCHMARK(Base64_Decode_BackInserter)
-//    ->Arg(128)
-//    ->Arg(1024)
-//    ->Arg(8 * 1024)
-//    ->Arg(64 * 1024)
-//    ->Arg(1024 * 1024);
+namespace boost { namespace radix { namespace codec_traits {
+template <>
+struct segment_bit_order<base64_lsb> {
+  BOOST_STATIC_CONSTANT(bit_order, value = bit_order_lsb_first);
+};
+}}} // namespace boost::radix::codec_traits
 
 #if !RADIXBENCH_DECODE_NOVALIDATION
 static void Base64_Encode_OutputDirect(benchmark::State& state) {
@@ -0,0 +1,395 @@
+//
+// benchmark/codec/rfc4648_matrix.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark/benchmark.h"
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base32hex.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/codec/rfc4648/base64url.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/encode_iterator.hpp>
+
+#include "../test/common.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Every RFC 4648 codec through every way the library is called, from 8 bytes
+// to 64MiB, to find the call shapes that are slow. Throughput is always in
+// raw bytes, so encode and decode of the same codec compare directly. Use
+// --benchmark_filter to pick out a codec or shape; the whole matrix takes a
+// while.
+using boost::radix::codec::rfc4648::base16;
+using boost::radix::codec::rfc4648::base32;
+using boost::radix::codec::rfc4648::base32hex;
+using boost::radix::codec::rfc4648::base64;
+using boost::radix::codec::rfc4648::base64url;
+
+namespace {
+
+std::size_t const max_input_size = 64 * 1024 * 1024;
+
+// Generated once and shared, so the large sizes don't each pay for it.
+std::vector<bits_type> const& random_input() {
+  static std::vector<bits_type> const input =
+      generate_random_bytes(max_input_size);
+  return input;
+}
+
+template <typename Codec>
+std::string encoded_input(
+    std::size_t size,
+    boost::radix::line_wrapping wrapping = boost::radix::line_wrapping()) {
+  bits_type const* data = random_input().data();
+  std::string encoded;
+  boost::radix::encode(
+      data, data + size, std::back_inserter(encoded), Codec(), wrapping);
+  return encoded;
+}
+
+void set_bytes_processed(benchmark::State& state) {
+  state.SetBytesProcessed(
+      int64_t(state.iterations()) * int64_t(state.range(0)));
+}
+
+// Steps of 8x from 8 bytes, ending on max_input_size.
+std::vector<int64_t> size_steps() {
+  std::vector<int64_t> sizes;
+  for(int64_t size = 8; size < int64_t(max_input_size); size *= 8)
+    sizes.push_back(size);
+  sizes.push_back(max_input_size);
+  return sizes;
+}
+
+void input_sizes(benchmark::internal::Benchmark* b) {
+  std::vector<int64_t> const sizes = size_steps();
+  for(std::size_t i = 0; i < sizes.size(); ++i)
+    b->Arg(sizes[i]);
+}
+
+// Streaming sizes paired with the size of each append.
+void chunked_input_sizes(benchmark::internal::Benchmark* b) {
+  std::vector<int64_t> const sizes = size_steps();
+  for(std::size_t i = 0; i < sizes.size(); ++i) {
+    for(int64_t chunk = 16; chunk <= 64 * 1024; chunk *= 16) {
+      if(chunk < sizes[i])
+        b->Args({sizes[i], chunk});
+    }
+  }
+}
+
+// Appends [first, last) to a streaming encoder or decoder chunk bytes at a
+// time.
+template <typename Stream, typename Iterator>
+void append_chunked(
+    Stream& stream, Iterator first, Iterator last, std::size_t chunk) {
+  while(first != last) {
+    Iterator next = first + std::min<std::size_t>(chunk, last - first);
+    stream.append(first, next);
+    first = next;
+  }
+}
+
+// Runs decode with an error handler constructed from the codec.
+template <typename Codec, typename ErrorHandler>
+void decode_with_handler(benchmark::State& state, std::string const& encoded) {
+  Codec codec;
+  std::vector<bits_type> result(state.range(0));
+  for(auto _ : state) {
+    ErrorHandler errh(codec);
+    boost::radix::decode(
+        encoded.data(), encoded.data() + encoded.size(), result.data(), codec,
+        errh);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+
+// As above, for the handlers reporting through an error code.
+template <typename Codec, typename ErrorHandler, typename ErrorCodeType>
+void decode_with_error_code_handler(
+    benchmark::State& state, std::string const& encoded) {
+  Codec codec;
+  std::vector<bits_type> result(state.range(0));
+  for(auto _ : state) {
+    ErrorCodeType errc = ErrorCodeType();
+    ErrorHandler errh(codec, errc);
+    boost::radix::decode(
+        encoded.data(), encoded.data() + encoded.size(), result.data(), codec,
+        errh);
+    benchmark::DoNotOptimize(errc);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+
+} // namespace
+
+#define RADIX_BENCH_CODECS(name, sizes)                                        \
+  BENCHMARK_TEMPLATE(name, base16)->Apply(sizes);                              \
+  BENCHMARK_TEMPLATE(name, base32)->Apply(sizes);                              \
+  BENCHMARK_TEMPLATE(name, base32hex)->Apply(sizes);                           \
+  BENCHMARK_TEMPLATE(name, base64)->Apply(sizes);                              \
+  BENCHMARK_TEMPLATE(name, base64url)->Apply(sizes)
+
+// -----------------------------------------------------------------------------
+// Encoding.
+template <typename Codec>
+static void Encode_Pointer(benchmark::State& state) {
+  Codec codec;
+  bits_type const* data = random_input().data();
+  std::vector<char_type> result(encoded_size(state.range(0), codec));
+  for(auto _ : state) {
+    boost::radix::encode(data, data + state.range(0), result.data(), codec);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Encode_Pointer, input_sizes);
+
+// A fresh string each time, growing as it goes, as most callers write it.
+template <typename Codec>
+static void Encode_BackInserter(benchmark::State& state) {
+  Codec codec;
+  bits_type const* data = random_input().data();
+  for(auto _ : state) {
+    std::string result;
+    boost::radix::encode(
+        data, data + state.range(0), std::back_inserter(result), codec);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Encode_BackInserter, input_sizes);
+
+template <typename Codec>
+static void Encode_EncodeIterator(benchmark::State& state) {
+  Codec codec;
+  bits_type const* data = random_input().data();
+  std::vector<char_type> result(encoded_size(state.range(0), codec));
+  for(auto _ : state) {
+    std::copy(
+        data, data + state.range(0),
+        boost::radix::make_encode_iterator(codec, result.data()));
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Encode_EncodeIterator, input_sizes);
+
+template <typename Codec>
+static void Encode_Encoder(benchmark::State& state) {
+  Codec codec;
+  bits_type const* data = random_input().data();
+  std::vector<char_type> result(encoded_size(state.range(0), codec));
+  for(auto _ : state) {
+    auto encoder = boost::radix::make_encoder(codec, result.data());
+    append_chunked(encoder, data, data + state.range(0), state.range(1));
+    encoder.resolve();
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Encode_Encoder, chunked_input_sizes);
+
+template <typename Codec>
+static void Encode_Mime(benchmark::State& state) {
+  Codec codec;
+  bits_type const* data = random_input().data();
+  boost::radix::line_wrapping const wrapping =
+      boost::radix::line_wrapping::mime();
+  std::vector<char_type> result(
+      encoded_size(state.range(0), codec, wrapping));
+  for(auto _ : state) {
+    boost::radix::encode(
+        data, data + state.range(0), result.data(), codec, wrapping);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Encode_Mime, input_sizes);
+
+// -----------------------------------------------------------------------------
+// Decoding. The default error handler throws.
+template <typename Codec>
+static void Decode_Pointer(benchmark::State& state) {
+  Codec codec;
+  std::string const encoded = encoded_input<Codec>(state.range(0));
+  std::vector<bits_type> result(state.range(0));
+  for(auto _ : state) {
+    boost::radix::decode(
+        encoded.data(), encoded.data() + encoded.size(), result.data(),
+        codec);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Decode_Pointer, input_sizes);
+
+template <typename Codec>
+static void Decode_BackInserter(benchmark::State& state) {
+  Codec codec;
+  std::string const encoded = encoded_input<Codec>(state.range(0));
+  for(auto _ : state) {
+    std::vector<bits_type> result;
+    boost::radix::decode(
+        encoded.begin(), encoded.end(), std::back_inserter(result), codec);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Decode_BackInserter, input_sizes);
+
+template <typename Codec>
+static void Decode_Decoder(benchmark::State& state) {
+  Codec codec;
+  std::string const encoded = encoded_input<Codec>(state.range(0));
+  std::vector<bits_type> result(state.range(0));
+  for(auto _ : state) {
+    auto decoder = boost::radix::make_decoder(codec, result.data());
+    append_chunked(
+        decoder, encoded.data(), encoded.data() + encoded.size(),
+        state.range(1));
+    decoder.resolve();
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Decode_Decoder, chunked_input_sizes);
+
+template <typename Codec>
+static void Decode_TryDecode(benchmark::State& state) {
+  Codec codec;
+  std::string const encoded = encoded_input<Codec>(state.range(0));
+  std::vector<bits_type> result(state.range(0));
+  for(auto _ : state) {
+    boost::radix::decode_result r = boost::radix::try_decode(
+        encoded.data(), encoded.data() + encoded.size(), result.data(),
+        codec);
+    benchmark::DoNotOptimize(r);
+    benchmark::DoNotOptimize(result);
+  }
+
+  set_bytes_processed(state);
+}
+RADIX_BENCH_CODECS(Decode_TryDecode, input_sizes);
+
+// -----------------------------------------------------------------------------
+// Each error handler on input it has nothing to report in.
+template <typename Codec>
+static void Decode_HandlerThrow(benchmark::State& state) {
+  decode_with_handler<Codec, boost::radix::decode_error_handler_throw>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerThrow, input_sizes);
+
+template <typename Codec>
+static void Decode_HandlerAssert(benchmark::State& state) {
+  decode_with_handler<Codec, boost::radix::decode_error_handler_assert>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerAssert, input_sizes);
+
+template <typename Codec>
+static void Decode_HandlerIgnore(benchmark::State& state) {
+  decode_with_handler<Codec, boost::radix::decode_error_handler_ignore>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerIgnore, input_sizes);
+
+template <typename Codec>
+static void Decode_HandlerErrorCode(benchmark::State& state) {
+  decode_with_error_code_handler<
+      Codec,
+      boost::radix::decode_error_handler_error_code<
+          boost::radix::decode_validation::error>,
+      boost::radix::decode_validation::error>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerErrorCode, input_sizes);
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+template <typename Codec>
+static void Decode_HandlerBoostErrorCode(benchmark::State& state) {
+  decode_with_error_code_handler<
+      Codec,
+      boost::radix::decode_error_handler_error_code<boost::system::error_code>,
+      boost::system::error_code>(state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerBoostErrorCode, input_sizes);
+#endif
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+template <typename Codec>
+static void Decode_HandlerStdErrorCode(benchmark::State& state) {
+  decode_with_error_code_handler<
+      Codec,
+      boost::radix::decode_error_handler_error_code<std::error_code>,
+      std::error_code>(state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerStdErrorCode, input_sizes);
+#endif
+
+template <typename Codec>
+static void Decode_HandlerSkipWhitespace(benchmark::State& state) {
+  decode_with_handler<Codec, boost::radix::decode_error_handler_skip_whitespace>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerSkipWhitespace, input_sizes);
+
+template <typename Codec>
+static void Decode_HandlerSkipWhitespaceErrorCode(benchmark::State& state) {
+  decode_with_error_code_handler<
+      Codec,
+      boost::radix::decode_error_handler_skip_whitespace_error_code<
+          boost::radix::decode_validation::error>,
+      boost::radix::decode_validation::error>(
+      state, encoded_input<Codec>(state.range(0)));
+}
+RADIX_BENCH_CODECS(Decode_HandlerSkipWhitespaceErrorCode, input_sizes);
+
+// The whitespace skipping handlers on the input they are for.
+template <typename Codec>
+static void Decode_HandlerSkipWhitespace_Mime(benchmark::State& state) {
+  decode_with_handler<Codec, boost::radix::decode_error_handler_skip_whitespace>(
+      state, encoded_input<Codec>(
+                 state.range(0), boost::radix::line_wrapping::mime()));
+}
+RADIX_BENCH_CODECS(Decode_HandlerSkipWhitespace_Mime, input_sizes);
+
+template <typename Codec>
+static void Decode_HandlerSkipWhitespaceErrorCode_Mime(
+    benchmark::State& state) {
+  decode_with_error_code_handler<
+      Codec,
+      boost::radix::decode_error_handler_skip_whitespace_error_code<
+          boost::radix::decode_validation::error>,
+      boost::radix::decode_validation::error>(
+      state, encoded_input<Codec>(
+                 state.range(0), boost::radix::line_wrapping::mime()));
+}
+RADIX_BENCH_CODECS(Decode_HandlerSkipWhitespaceErrorCode_Mime, input_sizes);
+
+BENCHMARK_MAIN();
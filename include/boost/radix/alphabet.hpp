@@ -79,6 +79,14 @@ class alphabet {
     return pad_bits_;
   }
 
+  // Lets c decode to bits as well as the character bits encodes to, for
+  // codecs that accept more than one spelling of a symbol.
+  void add_decode_alias(char_type c, bits_type bits) {
+    BOOST_ASSERT(bits < Size);
+    BOOST_ASSERT(bits_[(unsigned char)(c)] == Size);
+    bits_[(unsigned char)(c)] = bits;
+  }
+
   void set_pads(bits_type pad_bits, char_type pad_char) {
     BOOST_ASSERT(pad_bits > Size);
     BOOST_ASSERT(
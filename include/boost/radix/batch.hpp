@@ -0,0 +1,135 @@
+//
+// boost/radix/batch.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_BATCH_HPP
+#define BOOST_RADIX_BATCH_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
+#include <boost/range/size.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+// -----------------------------------------------------------------------------
+// Batch conversion of many small messages into a single columnar buffer. The
+// input is a range of ranges (one per message) and the output is one
+// contiguous buffer plus an offsets array of size n + 1, where message i
+// occupies [offsets[i], offsets[i + 1]), in the style of Apache Arrow.
+//
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// Total size of the encoded output for all messages in the batch. Allocating
+// exactly this many chars is sufficient for encode_batch.
+template <typename InputSequence, typename Codec>
+std::size_t encoded_batch_size(InputSequence const& inputs, Codec const& codec) {
+  typedef typename boost::range_iterator<InputSequence const>::type
+      input_iterator;
+  std::size_t total = 0;
+  for(input_iterator i = boost::begin(inputs), e = boost::end(inputs); i != e;
+      ++i) {
+    total += encoded_size(boost::size(*i), codec);
+  }
+  return total;
+}
+
+// -----------------------------------------------------------------------------
+// Upper bound on the decoded output for all messages in the batch. The exact
+// size depends on the padding of each message and is only known once the
+// batch has been decoded.
+template <typename InputSequence, typename Codec>
+std::size_t decoded_batch_size(InputSequence const& inputs, Codec const& codec) {
+  typedef typename boost::range_iterator<InputSequence const>::type
+      input_iterator;
+  std::size_t total = 0;
+  for(input_iterator i = boost::begin(inputs), e = boost::end(inputs); i != e;
+      ++i) {
+    total += decoded_size(boost::size(*i), codec);
+  }
+  return total;
+}
+
+// -----------------------------------------------------------------------------
+// Encodes every message in inputs into out, writing n + 1 offsets. A single
+// encoder is reused for the whole batch, so the per message cost is the
+// conversion itself plus one tail fill.
+template <typename InputSequence, typename OffsetIterator, typename Codec>
+std::size_t encode_batch(
+    InputSequence const& inputs,
+    char_type* out,
+    OffsetIterator offsets,
+    Codec const& codec) {
+  typedef typename boost::range_iterator<InputSequence const>::type
+      input_iterator;
+
+  encoder<Codec, char_type*> e(codec, out);
+  *offsets++ = 0;
+  for(input_iterator i = boost::begin(inputs), end = boost::end(inputs);
+      i != end; ++i) {
+    e.append(boost::begin(*i), boost::end(*i));
+    e.resolve();
+    *offsets++ = e.bytes_written();
+  }
+
+  BOOST_ASSERT(e.bytes_written() <= encoded_batch_size(inputs, codec));
+  return e.bytes_written();
+}
+
+// -----------------------------------------------------------------------------
+// Decodes every message in inputs into out, writing n + 1 offsets and one
+// decode_validation::error per message to status. A message that fails to
+// decode contributes no output, so its offsets are equal, and decoding
+// continues with the next message.
+template <
+    typename InputSequence,
+    typename OffsetIterator,
+    typename StatusIterator,
+    typename Codec>
+std::size_t decode_batch(
+    InputSequence const& inputs,
+    bits_type* out,
+    OffsetIterator offsets,
+    StatusIterator status,
+    Codec const& codec) {
+  typedef typename boost::range_iterator<InputSequence const>::type
+      input_iterator;
+
+  decoder<Codec, bits_type*> d(codec, out);
+  std::size_t offset = 0;
+  *offsets++         = offset;
+  for(input_iterator i = boost::begin(inputs), end = boost::end(inputs);
+      i != end; ++i) {
+    decode_validation::error errc = decode_validation::none;
+    decode_error_handler_error_code<decode_validation::error> errh(codec, errc);
+    d.append(boost::begin(*i), boost::end(*i), errh);
+    if(errc == decode_validation::none) {
+      d.resolve();
+      offset += d.bytes_written();
+    }
+
+    d.reset(out + offset);
+    *offsets++ = offset;
+    *status++  = errc;
+  }
+
+  return offset;
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_BATCH_HPP
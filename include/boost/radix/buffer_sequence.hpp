@@ -0,0 +1,96 @@
+//
+// boost/radix/buffer_sequence.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_BUFFERSEQUENCE_HPP
+#define BOOST_RADIX_BUFFERSEQUENCE_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
+
+#include <iterator>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// Output iterator that scatters its writes across a sequence of buffers. A
+// buffer sequence is any range whose elements are themselves ranges, such as
+// a std::vector<boost::iterator_range<char*> > built from an iovec array.
+// Empty buffers are skipped. Writing past the end of the last buffer is an
+// error.
+template <typename MutableBufferSequence>
+class buffer_sequence_output_iterator
+    : public std::iterator<std::output_iterator_tag, void, void, void, void> {
+  typedef typename boost::range_iterator<MutableBufferSequence>::type
+      buffer_iterator;
+  typedef typename boost::range_iterator<
+      typename std::iterator_traits<buffer_iterator>::value_type>::type
+      element_iterator;
+
+ public:
+  explicit buffer_sequence_output_iterator(MutableBufferSequence& buffers)
+      : buffer_(boost::begin(buffers))
+      , buffer_end_(boost::end(buffers))
+      , current_()
+      , end_() {
+    if(buffer_ != buffer_end_) {
+      current_ = boost::begin(*buffer_);
+      end_     = boost::end(*buffer_);
+    }
+  }
+
+  buffer_sequence_output_iterator& operator++() {
+    return *this;
+  }
+
+  buffer_sequence_output_iterator& operator++(int) {
+    return *this;
+  }
+
+  buffer_sequence_output_iterator& operator*() {
+    return *this;
+  }
+
+  template <typename T>
+  buffer_sequence_output_iterator& operator=(T const& t) {
+    while(current_ == end_) {
+      BOOST_ASSERT(buffer_ != buffer_end_);
+      ++buffer_;
+      BOOST_ASSERT(buffer_ != buffer_end_);
+      current_ = boost::begin(*buffer_);
+      end_     = boost::end(*buffer_);
+    }
+
+    *current_++ = t;
+    return *this;
+  }
+
+ private:
+  buffer_iterator buffer_;
+  buffer_iterator buffer_end_;
+  element_iterator current_;
+  element_iterator end_;
+};
+
+template <typename MutableBufferSequence>
+buffer_sequence_output_iterator<MutableBufferSequence>
+make_buffer_sequence_output_iterator(MutableBufferSequence& buffers) {
+  return buffer_sequence_output_iterator<MutableBufferSequence>(buffers);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_BUFFERSEQUENCE_HPP
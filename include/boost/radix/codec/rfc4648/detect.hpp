@@ -0,0 +1,413 @@
+//
+// boost/radix/codec/rfc4648/detect.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_CODEC_RFC4648_DETECT_HPP
+#define BOOST_RADIX_CODEC_RFC4648_DETECT_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base32hex.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/codec/rfc4648/base64url.hpp>
+#include <boost/radix/codec_traits/pad.hpp>
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/detail/char_set.hpp>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace boost { namespace radix { namespace codec { namespace rfc4648 {
+
+enum encoding
+{
+    encoding_base16,
+    encoding_base32,
+    encoding_base32hex,
+    encoding_base64,
+    encoding_base64url,
+};
+
+// How the length of the input fits an encoding's segments.
+enum length_fit
+{
+    // Whole segments, or a final segment completed by its padding.
+    length_fit_whole_segments,
+    // Unpadded, ending with a partial segment that still decodes to whole
+    // bytes.
+    length_fit_partial_segment,
+    // Left over symbols that can't make a byte, or the wrong padding.
+    length_fit_none,
+};
+
+struct detected_encoding
+{
+    encoding codec;
+    length_fit fit;
+
+    // log2 of the chance that input of this length drawn uniformly from the
+    // encoding's alphabet would use only the character classes seen. Higher
+    // is more likely; smaller alphabets that still cover the input win.
+    double log_likelihood;
+};
+
+// The encodings the input is made up of the alphabet of, most likely first:
+// ranked by how the length fits, then by likelihood.
+class detection_result
+{
+public:
+    typedef detected_encoding const* const_iterator;
+
+    detection_result()
+        : size_(0)
+    {}
+
+    const_iterator begin() const
+    {
+        return candidates_.data();
+    }
+
+    const_iterator end() const
+    {
+        return candidates_.data() + size_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    detected_encoding const& operator[](std::size_t i) const
+    {
+        return candidates_[i];
+    }
+
+    bool contains(encoding codec) const
+    {
+        for(const_iterator i = begin(); i != end(); ++i)
+        {
+            if(i->codec == codec)
+                return true;
+        }
+        return false;
+    }
+
+    void add(detected_encoding const& candidate)
+    {
+        candidates_[size_++] = candidate;
+    }
+
+    void rank()
+    {
+        std::stable_sort(
+            candidates_.begin(), candidates_.begin() + size_, more_likely);
+    }
+
+private:
+    static bool more_likely(
+        detected_encoding const& a, detected_encoding const& b)
+    {
+        if(a.fit != b.fit)
+            return a.fit < b.fit;
+        return a.log_likelihood > b.log_likelihood;
+    }
+
+    boost::array<detected_encoding, 5> candidates_;
+    std::size_t size_;
+};
+
+namespace detail {
+
+// The characters of all five alphabets split into classes that each
+// alphabet either contains completely or not at all, so a histogram of which
+// classes occur says which alphabets the input could be in.
+enum symbol_class
+{
+    class_digit_01_89,
+    class_shared,  // 2-7 and A-F, in every alphabet
+    class_upper_g_v,
+    class_upper_w_z,
+    class_lower,
+    class_plus_slash,
+    class_dash_underscore,
+    class_pad,
+    class_other,
+    num_symbol_classes
+};
+
+inline symbol_class classify(char_type c)
+{
+    if(c == '0' || c == '1' || c == '8' || c == '9')
+        return class_digit_01_89;
+    if((c >= '2' && c <= '7') || (c >= 'A' && c <= 'F'))
+        return class_shared;
+    if(c >= 'G' && c <= 'V')
+        return class_upper_g_v;
+    if(c >= 'W' && c <= 'Z')
+        return class_upper_w_z;
+    if(c >= 'a' && c <= 'z')
+        return class_lower;
+    if(c == '+' || c == '/')
+        return class_plus_slash;
+    if(c == '-' || c == '_')
+        return class_dash_underscore;
+    if(c == '=')
+        return class_pad;
+    return class_other;
+}
+
+// Which classes an alphabet contains and how many of its symbols are in each.
+struct alphabet_profile
+{
+    std::size_t size;
+    std::size_t bits;
+    std::size_t unpacked;
+    bool padded;
+    unsigned classes;
+    boost::array<std::size_t, num_symbol_classes> symbols;
+};
+
+template <typename Codec>
+alphabet_profile make_alphabet_profile(Codec const& codec)
+{
+    alphabet_profile profile;
+    profile.size = Codec::alphabet_size;
+    profile.bits = codec_traits::required_bits<Codec>::value;
+    profile.unpacked = codec_traits::unpacked_segment_size<Codec>::value;
+    profile.padded = codec_traits::requires_pad<Codec>::type::value;
+    profile.classes = 0;
+    profile.symbols.fill(0);
+    for(int i = 0; i < 256; ++i)
+    {
+        char_type c = static_cast<char_type>(i);
+        if(codec.has_char(c) && c != codec.get_pad_char())
+        {
+            ++profile.symbols[classify(c)];
+            profile.classes |= 1u << classify(c);
+        }
+    }
+    return profile;
+}
+
+struct detection_tables
+{
+    detection_tables()
+    {
+        boost::array<boost::array<bool, 256>, num_symbol_classes> members;
+        for(std::size_t k = 0; k < num_symbol_classes; ++k)
+            members[k].fill(false);
+        for(int i = 0; i < 256; ++i)
+        {
+            symbol_class k = classify(static_cast<char_type>(i));
+            classes[i] = static_cast<unsigned char>(k);
+            members[k][i] = true;
+        }
+
+        // Everything not in another class is class_other, so it needs no
+        // set of its own.
+        for(std::size_t k = 0; k < class_other; ++k)
+            sets[k] = boost::radix::detail::char_set(members[k]);
+
+        profiles[encoding_base16] = make_alphabet_profile(base16());
+        profiles[encoding_base32] = make_alphabet_profile(base32());
+        profiles[encoding_base32hex] = make_alphabet_profile(base32hex());
+        profiles[encoding_base64] = make_alphabet_profile(base64());
+        profiles[encoding_base64url] = make_alphabet_profile(base64url());
+    }
+
+    boost::array<unsigned char, 256> classes;
+    boost::array<boost::radix::detail::char_set, class_other> sets;
+    boost::array<alphabet_profile, 5> profiles;
+};
+
+inline detection_tables const& get_detection_tables()
+{
+    static detection_tables const tables;
+    return tables;
+}
+
+// What the one pass over the input gathers: the classes that occur, how
+// many characters there are, and how many pads, all of which must be at the
+// end.
+struct class_histogram
+{
+    class_histogram()
+        : classes(0)
+        , size(0)
+        , pads(0)
+        , trailing_pads(0)
+    {}
+
+    void add(detection_tables const& tables, char_type c)
+    {
+        unsigned k = tables.classes[static_cast<unsigned char>(c)];
+        classes |= 1u << k;
+        ++size;
+        if(k == class_pad)
+        {
+            ++pads;
+            ++trailing_pads;
+        }
+        else
+        {
+            trailing_pads = 0;
+        }
+    }
+
+    unsigned classes;
+    std::size_t size;
+    std::size_t pads;
+    std::size_t trailing_pads;
+};
+
+template <typename Iterator, typename EndIterator>
+class_histogram make_histogram(Iterator first, EndIterator last)
+{
+    detection_tables const& tables = get_detection_tables();
+    class_histogram histogram;
+    for(; first != last; ++first)
+        histogram.add(tables, *first);
+    return histogram;
+}
+
+// The class sets all fit the nibble lookup, so without it the table lookup
+// per character is as fast as it gets.
+inline class_histogram
+make_histogram(char_type const* first, char_type const* last)
+{
+    detection_tables const& tables = get_detection_tables();
+    class_histogram histogram;
+#if BOOST_RADIX_SIMD_SSSE3
+    boost::array<boost::uint32_t, class_other> seen;
+    seen.fill(0);
+    boost::uint32_t other = 0;
+    char_type const* blocks_first = first;
+    for(; last - first >= 32; first += 32)
+    {
+        boost::uint32_t any = 0;
+        for(std::size_t k = 0; k < class_other; ++k)
+        {
+            boost::uint32_t mask = tables.sets[k].mask(first);
+            seen[k] |= mask;
+            any |= mask;
+            if(k == class_pad)
+                histogram.pads += boost::radix::detail::popcount(mask);
+        }
+        other |= ~any;
+    }
+
+    histogram.size = first - blocks_first;
+    for(std::size_t k = 0; k < class_other; ++k)
+    {
+        if(seen[k])
+            histogram.classes |= 1u << k;
+    }
+    if(other)
+        histogram.classes |= 1u << class_other;
+
+    for(char_type const* i = first; i != blocks_first && i[-1] == '='; --i)
+        ++histogram.trailing_pads;
+#endif
+
+    for(; first != last; ++first)
+        histogram.add(tables, *first);
+    return histogram;
+}
+
+inline class_histogram make_histogram(char_type* first, char_type* last)
+{
+    return make_histogram(
+        static_cast<char_type const*>(first),
+        static_cast<char_type const*>(last));
+}
+
+inline length_fit fit_length(
+    alphabet_profile const& profile, std::size_t symbols, std::size_t pads)
+{
+    std::size_t const remainder = symbols % profile.unpacked;
+
+    // A partial segment has to hold at least one byte, and no more spare
+    // bits than a symbol carries.
+    bool const decodes = remainder == 0 ||
+                         (remainder * profile.bits >= 8 &&
+                          remainder * profile.bits % 8 < profile.bits);
+    if(!decodes)
+        return length_fit_none;
+    if(pads)
+    {
+        if(!profile.padded || !remainder ||
+           remainder + pads != profile.unpacked)
+            return length_fit_none;
+        return length_fit_whole_segments;
+    }
+    return remainder ? length_fit_partial_segment : length_fit_whole_segments;
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Works out which of the RFC 4648 encodings [first, last) could be, in one
+// pass over the input and without decoding it. Contiguous input is
+// classified 32 characters at a time.
+template <typename Iterator, typename EndIterator>
+detection_result detect(Iterator first, EndIterator last)
+{
+    using namespace detail;
+    class_histogram const histogram = make_histogram(first, last);
+    detection_tables const& tables = get_detection_tables();
+
+    detection_result result;
+    if(histogram.pads != histogram.trailing_pads)
+        return result;
+
+    std::size_t const symbols = histogram.size - histogram.pads;
+    unsigned const symbol_classes = histogram.classes & ~(1u << class_pad);
+    for(std::size_t i = 0; i < tables.profiles.size(); ++i)
+    {
+        alphabet_profile const& profile = tables.profiles[i];
+        if(symbol_classes & ~profile.classes)
+            continue;
+
+        std::size_t seen_symbols = 0;
+        for(std::size_t k = 0; k < num_symbol_classes; ++k)
+        {
+            if(symbol_classes & (1u << k))
+                seen_symbols += profile.symbols[k];
+        }
+
+        detected_encoding candidate;
+        candidate.codec = static_cast<encoding>(i);
+        candidate.fit = fit_length(profile, symbols, histogram.pads);
+        candidate.log_likelihood =
+            symbols ? symbols * std::log(double(seen_symbols) / profile.size) /
+                          std::log(2.0)
+                    : 0.0;
+        result.add(candidate);
+    }
+
+    result.rank();
+    return result;
+}
+
+}}}} // namespace boost::radix::codec::rfc4648
+
+#endif // BOOST_RADIX_CODEC_RFC4648_DETECT_HPP
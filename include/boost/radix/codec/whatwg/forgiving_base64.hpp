@@ -0,0 +1,128 @@
+//
+// boost/radix/codec/whatwg/forgiving_base64.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_CODEC_WHATWG_FORGIVINGBASE64_HPP
+#define BOOST_RADIX_CODEC_WHATWG_FORGIVINGBASE64_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/basic_codec.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_validation.hpp>
+
+#include <iterator>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace boost { namespace radix { namespace codec { namespace whatwg {
+
+// Based on the forgiving-base64 decode from
+// https://infra.spec.whatwg.org/#forgiving-base64
+//
+// Encodes as rfc4648::base64, but decodes both the base64 and base64url
+// spellings of the last two symbols, so mixed input needs no pre-cleaning.
+// The pad character is not part of the alphabet while decoding; use
+// forgiving_decode, which strips the optional trailing padding.
+class forgiving_base64 : public basic_codec<64>
+{
+public:
+    forgiving_base64()
+        : basic_codec("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/", '=')
+    {
+        add_decode_alias('-', 62);
+        add_decode_alias('_', 63);
+    }
+};
+
+// ASCII whitespace as defined by the spec, which unlike std::isspace does not
+// include vertical tab.
+inline bool is_ascii_whitespace(char_type c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+template <typename ErrorHandler>
+decode_validation::op validate_character(
+    forgiving_base64 const& codec, char_type c, ErrorHandler& errh)
+{
+    if(is_ascii_whitespace(c))
+        return errh.handle_whitespace_character(codec, c);
+    if(c == codec.get_pad_char() || !codec.has_char(c))
+        return errh.handle_nonalphabet_character(codec, c);
+    return decode_validation::op_consume;
+}
+
+// -----------------------------------------------------------------------------
+// Decodes [first, last) as atob does: whitespace is skipped, padding is
+// optional but must be correct when present, and input that stops part way
+// through a byte is an error. Contiguous input is decoded a block at a time
+// with the whitespace compacted out in the same pass; only the tail is
+// looked at separately, to find the padding.
+template <typename BidirectionalIterator, typename OutputIterator>
+decode_result forgiving_decode(
+    BidirectionalIterator first,
+    BidirectionalIterator last,
+    OutputIterator out) BOOST_NOEXCEPT
+{
+    forgiving_base64 codec;
+
+    BidirectionalIterator data_last = last;
+    std::size_t pads = 0;
+    for(BidirectionalIterator i = last; i != first;)
+    {
+        char_type c = *--i;
+        if(is_ascii_whitespace(c))
+            continue;
+        if(c != codec.get_pad_char() || pads == 2)
+            break;
+        data_last = i;
+        ++pads;
+    }
+
+    decode_result result;
+    decode_validation::error error = decode_validation::none;
+    decode_error_handler_skip_whitespace_error_code<decode_validation::error>
+        errh(codec, error);
+    decoder<forgiving_base64, OutputIterator> d(codec, out);
+
+    BidirectionalIterator stop = first;
+    d.append_until_error(stop, data_last, errh);
+    std::size_t const offset = std::distance(first, stop);
+    if(error == decode_validation::none)
+    {
+        // The padding only counts if it completes the final segment.
+        std::size_t const pending = d.pending_symbols();
+        if(pads && pending + pads != 4)
+            error = decode_validation::invalid_padding;
+        else if(pending == 1)
+            error = decode_validation::incomplete_segment;
+    }
+
+    // atob fails as a whole, so nothing counts as consumed, although the
+    // output written before the error was found is left in place.
+    if(error != decode_validation::none)
+    {
+        result.bytes_written = d.bytes_written();
+        result.error = error;
+        result.error_offset = offset;
+        return result;
+    }
+
+    d.resolve();
+    result.bytes_written = d.bytes_written();
+    result.bytes_consumed = std::distance(first, last);
+    result.error_offset = result.bytes_consumed;
+    return result;
+}
+
+}}}} // namespace boost::radix::codec::whatwg
+
+#endif // BOOST_RADIX_CODEC_WHATWG_FORGIVINGBASE64_HPP
@@ -0,0 +1,45 @@
+//
+// boost/radix/codec_traits/bit_order.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_CODECTRAITS_BITORDER_HPP
+#define BOOST_RADIX_CODECTRAITS_BITORDER_HPP
+
+#include <boost/radix/common.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// Where the first symbol of a segment goes. MSB first, as RFC 4648 does it,
+// puts it in the top bits of the first byte. LSB first puts it in the low
+// bits, treating the segment as a little endian number.
+enum bit_order
+{
+    bit_order_msb_first,
+    bit_order_lsb_first,
+};
+
+namespace codec_traits {
+
+// Specialise for codecs that pack LSB first. The default segment packer and
+// unpacker follow it, so the fast paths for either order are used without
+// overloading get_segment_packer or get_segment_unpacker.
+template <typename Codec>
+struct segment_bit_order
+{
+    BOOST_STATIC_CONSTANT(bit_order, value = bit_order_msb_first);
+};
+
+} // namespace codec_traits
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_CODECTRAITS_BITORDER_HPP
@@ -19,7 +19,15 @@
 #    pragma once
 #endif
 
-namespace boost { namespace radix { namespace codec_traits {
+namespace boost { namespace radix {
+
+enum line_terminator
+{
+    line_terminator_lf,
+    line_terminator_crlf,
+};
+
+namespace codec_traits {
 
 template <typename Codec>
 struct max_encoded_line_length
@@ -27,11 +35,17 @@ struct max_encoded_line_length
     BOOST_STATIC_CONSTANT(std::size_t, value = 0);
 };
 
+template <typename Codec>
+struct encoded_line_terminator
+{
+    BOOST_STATIC_CONSTANT(line_terminator, value = line_terminator_lf);
+};
+
 template <typename Codec>
 struct requires_line_breaks
 {
     typedef typename boost::conditional<
-        max_encoded_line_length<Codec>::value,
+        max_encoded_line_length<Codec>::value != 0,
         boost::true_type,
         boost::false_type>::type type;
 };
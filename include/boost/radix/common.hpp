@@ -33,4 +33,14 @@ typedef char char_type;
 #  define BOOST_RADIX_SUPPORT_BOOSTERRORCODE 1
 #endif
 
+#ifndef BOOST_RADIX_SUPPORT_PARALLEL
+#  if !defined(BOOST_NO_CXX11_HDR_THREAD) &&                                  \
+      !defined(BOOST_NO_CXX11_HDR_ATOMIC) &&                                  \
+      !defined(BOOST_NO_CXX11_HDR_MUTEX) &&                                   \
+      !defined(BOOST_NO_CXX11_HDR_CONDITION_VARIABLE) &&                      \
+      !defined(BOOST_NO_CXX11_HDR_FUNCTIONAL)
+#    define BOOST_RADIX_SUPPORT_PARALLEL 1
+#  endif
+#endif
+
 #endif // BOOST_RADIX_COMMON_HPP
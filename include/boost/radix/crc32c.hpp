@@ -0,0 +1,85 @@
+//
+// boost/radix/crc32c.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_CRC32C_HPP
+#define BOOST_RADIX_CRC32C_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/crc.hpp>
+
+#include <cstring>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// CRC-32C (Castagnoli), as used by iSCSI, ext4 and many storage formats,
+// for use as the accumulator of encoder::append and encode. Uses the SSE4.2
+// crc32 instruction when the target has it and boost::crc_optimal otherwise.
+class crc32c {
+ public:
+#if BOOST_RADIX_SIMD_SSE42
+  crc32c()
+      : crc_(0xFFFFFFFF) {
+  }
+
+  void process_bytes(void const* data, std::size_t size) {
+    unsigned char const* bytes = static_cast<unsigned char const*>(data);
+#  if defined(__x86_64__) || defined(_M_X64)
+    boost::uint64_t crc = crc_;
+    for(; size >= 8; size -= 8, bytes += 8) {
+      boost::uint64_t word;
+      std::memcpy(&word, bytes, 8);
+      crc = _mm_crc32_u64(crc, word);
+    }
+    crc_ = static_cast<boost::uint32_t>(crc);
+#  endif
+    for(; size; --size, ++bytes)
+      crc_ = _mm_crc32_u8(crc_, *bytes);
+  }
+
+  boost::uint32_t checksum() const {
+    return ~crc_;
+  }
+
+  void reset() {
+    crc_ = 0xFFFFFFFF;
+  }
+
+ private:
+  // The register before the final inversion.
+  boost::uint32_t crc_;
+#else
+  void process_bytes(void const* data, std::size_t size) {
+    crc_.process_bytes(data, size);
+  }
+
+  boost::uint32_t checksum() const {
+    return crc_.checksum();
+  }
+
+  void reset() {
+    crc_.reset();
+  }
+
+ private:
+  boost::crc_optimal<32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, true> crc_;
+#endif
+};
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_CRC32C_HPP
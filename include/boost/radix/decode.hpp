@@ -12,69 +12,53 @@
 
 #include <boost/radix/common.hpp>
 
+#include <boost/radix/codec_traits/bit_order.hpp>
 #include <boost/radix/codec_traits/pad.hpp>
 #include <boost/radix/codec_traits/segment.hpp>
-#include <boost/radix/exception.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/symbol_table.hpp>
+#include <boost/radix/static_obitstream_lsb.hpp>
 #include <boost/radix/static_obitstream_msb.hpp>
 
-#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
-#  include <boost/system/error_code.hpp>
-#endif
-
 #include <boost/move/utility.hpp>
-#include <cctype>
-
-#if BOOST_RADIX_SUPPORT_STDERRORCODE
-#  include <system_error>
-#endif
+#include <boost/optional.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
 
 #ifdef BOOST_HAS_PRAGMA_ONCE
 #  pragma once
 #endif
 
-namespace boost { namespace radix { namespace decode_validation {
+namespace boost { namespace radix {
 
-enum op {
-  op_consume,
-  op_skip,
-  op_abort,
-};
+namespace detail {
 
-enum error {
-  none = 0,
-  invalid_whitespace,
-  nonalphabet_character,
+// The packer for the codec's bit order.
+template <
+    typename Codec,
+    bit_order Order = codec_traits::segment_bit_order<Codec>::value>
+struct default_segment_packer {
+  typedef static_obitstream_msb<codec_traits::required_bits<Codec>::value>
+      type;
 };
 
-}}} // namespace boost::radix::decode_validation
-
-#if BOOST_RADIX_SUPPORT_STDERRORCODE
-namespace std {
-template <>
-struct is_error_code_enum<boost::radix::decode_validation::error>
-    : true_type {};
-} // namespace std
-#endif // BOOST_RADIX_SUPPORT_STDERRORCODE
-
-#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
-namespace boost { namespace system {
-template <>
-struct is_error_condition_enum<boost::radix::decode_validation::error> {
-  static const bool value = true;
+template <typename Codec>
+struct default_segment_packer<Codec, bit_order_lsb_first> {
+  typedef static_obitstream_lsb<codec_traits::required_bits<Codec>::value>
+      type;
 };
-}}     // namespace boost::system
-#endif // BOOST_RADIX_SUPPORT_BOOSTERRORCODE
 
-namespace boost { namespace radix {
+} // namespace detail
 
 // -----------------------------------------------------------------------------
 //
 namespace adl {
 
 template <typename Codec>
-static_obitstream_msb<codec_traits::required_bits<Codec>::value>
-get_segment_packer(Codec const& codec) {
-  return static_obitstream_msb<codec_traits::required_bits<Codec>::value>();
+typename detail::default_segment_packer<Codec>::type
+get_segment_packer(Codec const&) {
+  return typename detail::default_segment_packer<Codec>::type();
 }
 
 template <typename Codec>
@@ -85,108 +69,12 @@ std::size_t get_decoded_size(std::size_t source_size, Codec const& codec) {
   // By default, size is an integer multiple of the output
   // segment size.
   return packed_segment_size<Codec>::value *
-         (source_size + (unpacked_segment_size<Codec>::value - 1) /
-                            unpacked_segment_size<Codec>::value);
-}
-
-template <typename Codec>
-bool is_invalid_whitespace_character(Codec const& codec, char_type c) {
-  if(std::isspace(c)) {
-    return true;
-  }
-  return false;
-}
-
-template <typename Codec, typename ErrorHandler>
-decode_validation::op validate_character(
-    Codec const& codec, char_type c, ErrorHandler& errh) {
-  if(is_invalid_whitespace_character(codec, c))
-    return errh.handle_whitespace_character(codec, c);
-  if(!codec.has_char(c))
-    return errh.handle_nonalphabet_character(codec, c);
-  return decode_validation::op_consume;
+         ((source_size + (unpacked_segment_size<Codec>::value - 1)) /
+          unpacked_segment_size<Codec>::value);
 }
 
 } // namespace adl
 
-struct decode_error_handler_throw {
-  template <typename Codec>
-  decode_error_handler_throw(Codec const&) {
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
-    BOOST_THROW_EXCEPTION(invalid_whitespace(c));
-    return decode_validation::op_consume;
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_nonalphabet_character(
-      Codec const& codec, char_type c) {
-    BOOST_THROW_EXCEPTION(nonalphabet_character(c));
-    return decode_validation::op_consume;
-  }
-};
-
-template <typename ErrorCodeType>
-struct decode_error_handler_error_code {
-  template <typename Codec>
-  decode_error_handler_error_code(Codec const&, ErrorCodeType& errc)
-      : errc_(errc) {
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
-    errc_ = decode_validation::invalid_whitespace;
-    return decode_validation::op_abort;
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_nonalphabet_character(
-      Codec const& codec, char_type c) {
-    errc_ = decode_validation::nonalphabet_character;
-    return decode_validation::op_abort;
-  }
-
-  ErrorCodeType& errc_;
-};
-
-struct decode_error_handler_assert {
-  template <typename Codec>
-  decode_error_handler_assert(Codec const&) {
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
-    BOOST_ASSERT(false);
-    return decode_validation::op_consume;
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_nonalphabet_character(
-      Codec const& codec, char_type c) {
-    BOOST_ASSERT(false);
-    return decode_validation::op_consume;
-  }
-};
-
-struct decode_error_handler_ignore {
-  template <typename Codec>
-  decode_error_handler_ignore(Codec const&) {
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
-    return decode_validation::op_consume;
-  }
-
-  template <typename Codec>
-  decode_validation::op handle_nonalphabet_character(
-      Codec const& codec, char_type c) {
-    return decode_validation::op_consume;
-  }
-};
-
 // -----------------------------------------------------------------------------
 //
 template <typename Codec, typename OutputIterator>
@@ -195,7 +83,8 @@ class decoder {
   decoder(Codec const& codec, OutputIterator out)
       : codec_(codec)
       , out_(out)
-      , bytes_written_(0) {
+      , bytes_written_(0)
+      , next_validated_(false) {
   }
 
   template <typename Iterator, typename EndIterator>
@@ -246,6 +135,61 @@ class decoder {
   }
 #endif
 
+  // Appends using a user supplied error handler, see decode_error_handler_*
+  // for the interface it needs to satisfy.
+  template <typename Iterator, typename EndIterator, typename ErrorHandler>
+  std::size_t append(Iterator first, EndIterator last, ErrorHandler& errh) {
+    using boost::radix::adl::get_segment_packer;
+    std::size_t bytes_appended =
+        append_impl(first, last, get_segment_packer(codec_), errh);
+    bytes_written_ += bytes_appended;
+    return bytes_appended;
+  }
+
+  // As above, but first is advanced to where decoding stopped. That is last,
+  // unless the handler aborted, in which case it is the offending character.
+  template <typename Iterator, typename EndIterator, typename ErrorHandler>
+  std::size_t
+  append_until_error(Iterator& first, EndIterator last, ErrorHandler& errh) {
+    using boost::radix::adl::get_segment_packer;
+    std::size_t bytes_appended =
+        append_impl(first, last, get_segment_packer(codec_), errh);
+    bytes_written_ += bytes_appended;
+    return bytes_appended;
+  }
+
+  template <typename ConstBufferSequence>
+  std::size_t append_buffers(ConstBufferSequence const& buffers) {
+    std::size_t bytes_appended = 0;
+    for_each_buffer(buffers, buffer_appender(*this, bytes_appended));
+    return bytes_appended;
+  }
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+  template <typename ConstBufferSequence>
+  std::size_t append_buffers(
+      ConstBufferSequence const& buffers, boost::system::error_code& errc) {
+    std::size_t bytes_appended = 0;
+    for_each_buffer(
+        buffers,
+        buffer_appender_with_error<boost::system::error_code>(
+            *this, bytes_appended, errc));
+    return bytes_appended;
+  }
+#endif
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+  template <typename ConstBufferSequence>
+  std::size_t append_buffers(
+      ConstBufferSequence const& buffers, std::error_code& errc) {
+    std::size_t bytes_appended = 0;
+    for_each_buffer(
+        buffers, buffer_appender_with_error<std::error_code>(
+                     *this, bytes_appended, errc));
+    return bytes_appended;
+  }
+#endif
+
   std::size_t resolve() {
     if(unpacked_segment_.empty())
       return 0;
@@ -277,8 +221,21 @@ class decoder {
     return output_size;
   }
 
+  // Writes out the held back segment if it is complete, which it is when
+  // decoding stopped early with a whole segment still waiting to see whether
+  // it was the last. Any padding in it is dropped as in resolve().
+  std::size_t flush() {
+    if(unpacked_segment_.size() != unpacked_segment_.capacity())
+      return 0;
+
+    std::size_t const output_size = resolve();
+    unpacked_segment_.clear();
+    return output_size;
+  }
+
   void abort() {
     unpacked_segment_.clear();
+    next_validated_ = false;
   }
 
   void reset(OutputIterator out) {
@@ -287,10 +244,21 @@ class decoder {
     bytes_written_ = 0;
   }
 
+  // Carries on decoding into out, keeping any symbols not yet written.
+  void redirect(OutputIterator out) {
+    out_ = boost::move(out);
+  }
+
   std::size_t bytes_written() const {
     return bytes_written_;
   }
 
+  // Symbols buffered for the next segment or for resolve(). As at most one
+  // segment is held back, this is never more than a segment's worth.
+  std::size_t pending_symbols() const {
+    return unpacked_segment_.size();
+  }
+
  private:
   //
   template <
@@ -299,7 +267,7 @@ class decoder {
       typename SegmentPacker,
       typename ErrorHandler>
   std::size_t append_impl(
-      Iterator first,
+      Iterator& first,
       EndIterator last,
       SegmentPacker segment_packer,
       ErrorHandler& errh) {
@@ -315,17 +283,123 @@ class decoder {
       bytes_appended += codec_traits::packed_segment_size<Codec>::value;
     }
 
+    bytes_appended += write_blocks(first, last, segment_packer, errh);
     bytes_appended += direct_write_segments(first, last, segment_packer, errh);
     return bytes_appended;
   }
 
+  // Input in contiguous memory is converted to symbols a block at a time
+  // through a lookup table, with whitespace compacted out when the handler
+  // would skip it anyway. Only blocks containing something else that needs
+  // validating, or the padding, drop back to one character at a time.
+  template <
+      typename Iterator,
+      typename EndIterator,
+      typename SegmentPacker,
+      typename ErrorHandler>
+  std::size_t
+  write_blocks(Iterator&, EndIterator, SegmentPacker, ErrorHandler&) {
+    return 0;
+  }
+
+  template <typename SegmentPacker, typename ErrorHandler>
+  std::size_t write_blocks(
+      char_type*& first,
+      char_type* last,
+      SegmentPacker segment_packer,
+      ErrorHandler& errh) {
+    char_type const* cfirst = first;
+    std::size_t bytes_appended =
+        write_blocks(cfirst, cfirst + (last - first), segment_packer, errh);
+    first += cfirst - first;
+    return bytes_appended;
+  }
+
+  template <typename SegmentPacker, typename ErrorHandler>
+  std::size_t write_blocks(
+      char_type const*& first,
+      char_type const* last,
+      SegmentPacker segment_packer,
+      ErrorHandler&) {
+    typedef detail::symbol_table<Codec> symbol_table_type;
+    std::size_t const block_size = symbol_table_type::block_size;
+    std::size_t const unpacked_size =
+        codec_traits::unpacked_segment_size<Codec>::value;
+
+    BOOST_ASSERT(unpacked_segment_.empty());
+    if(!symbols_) {
+      // Building the table costs a validate_character call per character
+      // value, which short inputs never earn back.
+      if(last - first < static_cast<std::ptrdiff_t>(block_table_threshold))
+        return 0;
+      symbols_ = symbol_table_type(codec_);
+    }
+
+    boost::array<
+        bits_type,
+        symbol_table_type::block_size +
+            codec_traits::unpacked_segment_size<Codec>::value>
+        staged;
+    std::size_t num_staged     = 0;
+    std::size_t bytes_appended = 0;
+    while(last - first >= static_cast<std::ptrdiff_t>(block_size)) {
+      // Blocks of a 1 bit codec that start on a byte go straight to bytes.
+      boost::array<bits_type, block_size / 8> bytes;
+      if(!num_staged && is_binary_packer(segment_packer) &&
+         symbols_->to_bytes(first, bytes.data())) {
+        out_ = std::copy(bytes.begin(), bytes.end(), out_);
+        first += block_size;
+        bytes_appended += bytes.size();
+        continue;
+      }
+
+      std::size_t count;
+      if(!symbols_->to_symbols(
+             first, staged.begin() + num_staged, count,
+             error_handler_skips_whitespace<ErrorHandler>::value))
+        break;
+
+      // A character peeked at and validated by fill_unpacked_segment is now
+      // part of this block.
+      first += block_size;
+      next_validated_ = false;
+      num_staged += count;
+      std::size_t const segments = num_staged / unpacked_size;
+      out_ = detail::pack_segments<
+          codec_traits::packed_segment_size<Codec>::value, unpacked_size>(
+          segment_packer, staged.begin(), segments, out_);
+      bytes_appended +=
+          segments * codec_traits::packed_segment_size<Codec>::value;
+      bits_type const* segment = staged.begin() + segments * unpacked_size;
+      num_staged -= segments * unpacked_size;
+      std::copy(segment, segment + num_staged, staged.begin());
+    }
+
+    // Leftover symbols become the partial segment that the character at a
+    // time path carries on filling.
+    std::copy(
+        staged.begin(), staged.begin() + num_staged, unpacked_segment_.begin());
+    unpacked_segment_.resize(num_staged);
+    return bytes_appended;
+  }
+
+  // symbol_table::to_bytes packs bits as static_obitstream_msb<1> does.
+  template <typename SegmentPacker>
+  static bool is_binary_packer(SegmentPacker const&) {
+    return false;
+  }
+
+  static bool is_binary_packer(static_obitstream_msb<1> const&) {
+    return true;
+  }
+
   template <
       typename Iterator,
       typename EndIterator,
       typename SegmentPacker,
       typename ErrorHandler>
   std::size_t direct_write_segments(
-      Iterator first,
+      Iterator& first,
       EndIterator last,
       SegmentPacker segment_packer,
       ErrorHandler& errh) {
@@ -350,27 +424,110 @@ class decoder {
 
     typename unpacked_segment_type::iterator ubegin = unpacked_segment_.end();
     typename unpacked_segment_type::iterator uend =
-        ubegin + unpacked_segment_.capacity();
+        unpacked_segment_.begin() + unpacked_segment_.capacity();
 
     while(first != last && ubegin != uend) {
-      char_type c = *first++;
+      char_type c = *first;
+      if(next_validated_) {
+        next_validated_ = false;
+        *ubegin++       = codec_.bits_from_char(c);
+        ++first;
+        continue;
+      }
+
       using boost::radix::adl::validate_character;
       switch(validate_character(codec_, c, errh)) {
       case decode_validation::op_consume:
         *ubegin++ = codec_.bits_from_char(c);
+        ++first;
         break;
       case decode_validation::op_skip:
+        ++first;
         continue;
       case decode_validation::op_abort:
+        unpacked_segment_.resize(
+            std::distance(unpacked_segment_.begin(), ubegin));
         return false;
       }
     }
 
     unpacked_segment_.resize(std::distance(unpacked_segment_.begin(), ubegin));
     std::fill(ubegin, uend, 0);
-    return ubegin == uend && first != last;
+    if(ubegin != uend)
+      return false;
+
+    // A full segment is held back until another symbol arrives because the
+    // final segment may contain padding and needs to go through resolve().
+    // Trailing characters that are skipped don't count. The symbol found is
+    // left in the input, so note that it has been through the handler
+    // already and is not passed to it again.
+    while(first != last) {
+      using boost::radix::adl::validate_character;
+      switch(validate_character(codec_, *first, errh)) {
+      case decode_validation::op_consume:
+        next_validated_ = true;
+        return true;
+      case decode_validation::op_skip:
+        ++first;
+        continue;
+      case decode_validation::op_abort:
+        return false;
+      }
+    }
+
+    return false;
   }
 
+  struct buffer_appender {
+    buffer_appender(decoder& d, std::size_t& bytes_appended)
+        : decoder_(d)
+        , bytes_appended_(bytes_appended) {
+    }
+
+    template <typename Iterator>
+    bool operator()(Iterator first, Iterator last) const {
+      bytes_appended_ += decoder_.append(first, last);
+      return true;
+    }
+
+    decoder& decoder_;
+    std::size_t& bytes_appended_;
+  };
+
+  template <typename ErrorCodeType>
+  struct buffer_appender_with_error {
+    buffer_appender_with_error(
+        decoder& d, std::size_t& bytes_appended, ErrorCodeType& errc)
+        : decoder_(d)
+        , bytes_appended_(bytes_appended)
+        , errc_(errc) {
+    }
+
+    template <typename Iterator>
+    bool operator()(Iterator first, Iterator last) const {
+      bytes_appended_ += decoder_.append(first, last, errc_);
+      return !errc_;
+    }
+
+    decoder& decoder_;
+    std::size_t& bytes_appended_;
+    ErrorCodeType& errc_;
+  };
+
+  template <typename ConstBufferSequence, typename BufferAppender>
+  void for_each_buffer(
+      ConstBufferSequence const& buffers, BufferAppender appender) {
+    typedef typename boost::range_iterator<ConstBufferSequence const>::type
+        buffer_iterator;
+    for(buffer_iterator i = boost::begin(buffers), e = boost::end(buffers);
+        i != e; ++i) {
+      if(!appender(boost::begin(*i), boost::end(*i)))
+        break;
+    }
+  }
+
+  BOOST_STATIC_CONSTANT(std::size_t, block_table_threshold = 1024);
+
   Codec const& codec_;
   OutputIterator out_;
   std::size_t bytes_written_;
@@ -380,6 +537,8 @@ class decoder {
       codec_traits::unpacked_segment_size<Codec>::value>
       unpacked_segment_type;
   unpacked_segment_type unpacked_segment_;
+  bool next_validated_;
+  boost::optional<detail::symbol_table<Codec> > symbols_;
 }; // namespace radix
 
 template <typename Codec, typename OutputIterator>
@@ -396,6 +555,98 @@ std::size_t decoded_size(std::size_t source_size, Codec const& codec) {
   return get_decoded_size(source_size, codec);
 }
 
+namespace detail {
+
+// Counts the characters the decoder would consume and the length of the run
+// of pad characters they end with. Whitespace and other characters outside
+// the alphabet are ignored.
+template <typename Iterator, typename EndIterator, typename Codec>
+std::size_t count_symbols(
+    Iterator first,
+    EndIterator last,
+    Codec const& codec,
+    std::size_t& trailing_pads) {
+  std::size_t count = 0;
+  trailing_pads     = 0;
+  for(; first != last; ++first) {
+    char_class_probe probe;
+    using boost::radix::adl::validate_character;
+    validate_character(codec, *first, probe);
+    if(probe.result != char_class_alphabet)
+      continue;
+    ++count;
+    if(*first == codec.get_pad_char())
+      ++trailing_pads;
+    else
+      trailing_pads = 0;
+  }
+  return count;
+}
+
+template <typename Codec>
+std::size_t count_symbols_contiguous(
+    char_type const* first,
+    char_type const* last,
+    Codec const& codec,
+    std::size_t& trailing_pads) {
+  if(last - first < static_cast<std::ptrdiff_t>(char_classifier_threshold))
+    return count_symbols(first, last, codec, trailing_pads);
+
+  char_classifier<Codec> classifier(codec);
+  std::size_t const count = make_alphabet_char_set(classifier).count(first, last);
+
+  // Only the tail needs looking at to find where the padding starts.
+  trailing_pads = 0;
+  while(first != last) {
+    char_type c = *--last;
+    if(classifier.classify(c) != char_class_alphabet)
+      continue;
+    if(c != codec.get_pad_char())
+      break;
+    ++trailing_pads;
+  }
+  return count;
+}
+
+template <typename Iterator, typename EndIterator, typename Codec>
+std::size_t count_decoded_bytes(
+    Iterator first, EndIterator last, Codec const& codec) {
+  std::size_t trailing_pads;
+  std::size_t count = count_symbols(first, last, codec, trailing_pads);
+  return decoded_size_of_symbols<Codec>(count, count - trailing_pads);
+}
+
+template <typename Codec>
+std::size_t count_decoded_bytes(
+    char_type const* first, char_type const* last, Codec const& codec) {
+  std::size_t trailing_pads;
+  std::size_t count =
+      count_symbols_contiguous(first, last, codec, trailing_pads);
+  return decoded_size_of_symbols<Codec>(count, count - trailing_pads);
+}
+
+template <typename Codec>
+std::size_t
+count_decoded_bytes(char_type* first, char_type* last, Codec const& codec) {
+  return count_decoded_bytes(
+      static_cast<char_type const*>(first), static_cast<char_type const*>(last),
+      codec);
+}
+
+} // namespace detail
+
+// Works out exactly how many bytes [first, last) decodes to, without
+// decoding it, so the output can be allocated once up front. Unlike
+// decoded_size this accounts for whitespace, missing padding and padding at
+// the end of the input. Characters outside the alphabet are not counted, so
+// the result is exact for any input that decodes successfully with
+// decode_error_handler_skip_whitespace or stricter.
+template <typename Iterator, typename EndIterator, typename Codec>
+std::size_t
+count_decoded_bytes(Iterator first, EndIterator last, Codec const& codec) {
+  return detail::count_decoded_bytes(first, last, codec);
+}
+
 // -----------------------------------------------------------------------------
 //
 template <
@@ -414,6 +665,26 @@ std::size_t decode(
   return d.bytes_written();
 }
 
+// Decodes using a user supplied error handler, such as
+// decode_error_handler_skip_whitespace for line wrapped input.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec,
+    typename ErrorHandler>
+std::size_t decode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    ErrorHandler& errh) {
+  decoder<Codec, OutputIterator> d(codec, out);
+  d.append(first, last, errh);
+  d.resolve();
+  return d.bytes_written();
+}
+
 #if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
 template <
     typename InputIterator,
@@ -452,6 +723,117 @@ std::size_t decode(
 }
 #endif
 
+// -----------------------------------------------------------------------------
+//
+struct decode_result {
+  decode_result()
+      : bytes_written(0)
+      , bytes_consumed(0)
+      , error(decode_validation::none)
+      , error_offset(0) {
+  }
+
+  bool ok() const {
+    return error == decode_validation::none;
+  }
+
+  std::size_t bytes_written;
+
+  // Input characters accounted for by the output, so decoding can resume
+  // from here. On error this is the start of the segment containing the
+  // offending character.
+  std::size_t bytes_consumed;
+
+  decode_validation::error error;
+
+  // Offset of the offending character, or the length of the input when ok.
+  std::size_t error_offset;
+};
+
+// Decodes without throwing on bad input. Every character outside the
+// alphabet, including whitespace, is an error. Contiguous input is checked a
+// block at a time rather than per character. On error the output holds the
+// whole segments before the offending character and nothing is resolved.
+// The output iterator must not throw either.
+template <
+    typename ForwardIterator,
+    typename ForwardEndIterator,
+    typename OutputIterator,
+    typename Codec>
+decode_result try_decode(
+    ForwardIterator first,
+    ForwardEndIterator last,
+    OutputIterator out,
+    Codec const& codec) BOOST_NOEXCEPT {
+  decode_result result;
+  decode_validation::error error = decode_validation::none;
+  decode_error_handler_error_code<decode_validation::error> errh(codec, error);
+  decoder<Codec, OutputIterator> d(codec, out);
+
+  ForwardIterator stop = first;
+  d.append_until_error(stop, last, errh);
+  std::size_t const offset = std::distance(first, stop);
+  if(error != decode_validation::none) {
+    std::size_t segments =
+        d.bytes_written() / codec_traits::packed_segment_size<Codec>::value;
+    if(d.flush())
+      ++segments;
+    result.bytes_written = d.bytes_written();
+    result.bytes_consumed =
+        segments * codec_traits::unpacked_segment_size<Codec>::value;
+    result.error        = error;
+    result.error_offset = offset;
+    return result;
+  }
+
+  d.resolve();
+  result.bytes_written  = d.bytes_written();
+  result.bytes_consumed = offset;
+  result.error_offset   = offset;
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+//
+template <typename ConstBufferSequence, typename OutputIterator, typename Codec>
+std::size_t decode_buffers(
+    ConstBufferSequence const& buffers,
+    OutputIterator out,
+    Codec const& codec) {
+  decoder<Codec, OutputIterator> d(codec, out);
+  d.append_buffers(buffers);
+  d.resolve();
+  return d.bytes_written();
+}
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+template <typename ConstBufferSequence, typename OutputIterator, typename Codec>
+std::size_t decode_buffers(
+    ConstBufferSequence const& buffers,
+    OutputIterator out,
+    Codec const& codec,
+    boost::system::error_code& errc) {
+  decoder<Codec, OutputIterator> d(codec, out);
+  d.append_buffers(buffers, errc);
+  d.resolve();
+  return d.bytes_written();
+}
+#endif
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+template <typename ConstBufferSequence, typename OutputIterator, typename Codec>
+std::size_t decode_buffers(
+    ConstBufferSequence const& buffers,
+    OutputIterator out,
+    Codec const& codec,
+    std::error_code& errc) {
+  decoder<Codec, OutputIterator> d(codec, out);
+  d.append_buffers(buffers, errc);
+  d.resolve();
+  return d.bytes_written();
+}
+#endif
+
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_DECODE_HPP
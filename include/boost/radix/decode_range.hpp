@@ -0,0 +1,292 @@
+//
+// boost/radix/decode_range.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DECODERANGE_HPP
+#define BOOST_RADIX_DECODERANGE_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/line_wrapping.hpp>
+
+#include <boost/array.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// Maps symbol positions to text positions in line wrapped text whose lines
+// need not all be the same length, so that decode_range can find any segment
+// without reading the text before it. Lines end at '\n', and a '\r' before it
+// is part of the terminator. Everything else on a line is taken to be a
+// symbol.
+//
+// Consecutive lines of the same length are stored as one run, so text
+// wrapped the way encode wraps it needs only a couple of entries however long
+// it is.
+class line_index {
+ public:
+  line_index()
+      : symbols_(0)
+      , size_(0) {
+  }
+
+  template <typename RandomAccessIterator>
+  line_index(RandomAccessIterator first, RandomAccessIterator last)
+      : symbols_(0)
+      , size_(last - first) {
+    RandomAccessIterator line = first;
+    while(line != last) {
+      RandomAccessIterator newline = std::find(line, last, '\n');
+      RandomAccessIterator next    = newline == last ? last : newline + 1;
+      if(newline != last && newline != line && newline[-1] == '\r')
+        --newline;
+      add_line(line - first, newline - line, next - line);
+      line = next;
+    }
+  }
+
+  // Number of symbols in the text.
+  std::size_t symbols() const {
+    return symbols_;
+  }
+
+  // Offset in the text of the symbol at symbol_offset, or of the end of the
+  // text for symbol_offset == symbols().
+  std::size_t position(std::size_t symbol_offset) const {
+    if(symbol_offset >= symbols_)
+      return size_;
+
+    std::vector<run>::const_iterator r = std::upper_bound(
+        runs_.begin(), runs_.end(), symbol_offset, starts_after);
+    --r;
+    std::size_t const into_run = symbol_offset - r->first_symbol;
+    return r->first_position + into_run / r->line_symbols * r->line_size +
+           into_run % r->line_symbols;
+  }
+
+ private:
+  struct run {
+    std::size_t first_symbol;
+    std::size_t first_position;
+    std::size_t line_symbols;
+    std::size_t line_size;
+    std::size_t lines;
+  };
+
+  static bool starts_after(std::size_t symbol_offset, run const& r) {
+    return symbol_offset < r.first_symbol;
+  }
+
+  // Lines with no symbols are only recorded by the run after them starting
+  // further on.
+  void add_line(
+      std::size_t position, std::size_t line_symbols, std::size_t line_size) {
+    if(!line_symbols)
+      return;
+
+    if(!runs_.empty()) {
+      run& last = runs_.back();
+      if(last.line_symbols == line_symbols && last.line_size == line_size &&
+         last.first_position + last.lines * line_size == position) {
+        ++last.lines;
+        symbols_ += line_symbols;
+        return;
+      }
+    }
+
+    run r = {symbols_, position, line_symbols, line_size, 1};
+    runs_.push_back(r);
+    symbols_ += line_symbols;
+  }
+
+  std::vector<run> runs_;
+  std::size_t symbols_;
+  std::size_t size_;
+};
+
+namespace detail {
+
+// Symbol positions in text with no line breaks.
+struct unwrapped_positions {
+  explicit unwrapped_positions(std::size_t size)
+      : size_(size) {
+  }
+
+  std::size_t symbols() const {
+    return size_;
+  }
+
+  std::size_t position(std::size_t symbol_offset) const {
+    return std::min(symbol_offset, size_);
+  }
+
+  std::size_t size_;
+};
+
+// Symbol positions in text wrapped the way encode wraps it, with every line
+// but the last holding line_length symbols.
+struct wrapped_positions {
+  wrapped_positions(line_wrapping const& wrapping, std::size_t size)
+      : line_length_(wrapping.line_length())
+      , line_size_(wrapping.line_length() + wrapping.terminator_size())
+      , size_(size) {
+  }
+
+  std::size_t symbols() const {
+    return size_ / line_size_ * line_length_ +
+           std::min(size_ % line_size_, line_length_);
+  }
+
+  std::size_t position(std::size_t symbol_offset) const {
+    return std::min(
+        size_, symbol_offset / line_length_ * line_size_ +
+                   symbol_offset % line_length_);
+  }
+
+  std::size_t line_length_;
+  std::size_t line_size_;
+  std::size_t size_;
+};
+
+// Decodes just the segments holding bytes [byte_first, byte_last). The
+// decoder writes to a buffer a chunk at a time, so the bytes before the range
+// in the first segment and after it in the last can be dropped.
+template <
+    typename RandomAccessIterator,
+    typename OutputIterator,
+    typename Codec,
+    typename Positions,
+    typename ErrorHandler>
+std::size_t decode_range(
+    RandomAccessIterator first,
+    std::size_t byte_first,
+    std::size_t byte_last,
+    OutputIterator out,
+    Codec const& codec,
+    Positions const& positions,
+    ErrorHandler& errh) {
+  std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+  std::size_t const unpacked =
+      codec_traits::unpacked_segment_size<Codec>::value;
+  std::size_t const symbol_first = byte_first / packed * unpacked;
+  if(byte_first >= byte_last || symbol_first >= positions.symbols())
+    return 0;
+
+  std::size_t const symbol_last =
+      (byte_last + packed - 1) / packed * unpacked;
+  RandomAccessIterator text      = first + positions.position(symbol_first);
+  RandomAccessIterator text_last = first + positions.position(symbol_last);
+
+  boost::array<bits_type, 4096> buffer;
+  std::size_t const chunk = buffer.size() / packed * unpacked - unpacked;
+  decoder<Codec, bits_type*> d(codec, buffer.data());
+  std::size_t skip    = byte_first % packed;
+  std::size_t remains = byte_last - byte_first;
+  std::size_t written = 0;
+  bool resolved       = false;
+  while(remains && !resolved) {
+    d.redirect(buffer.data());
+    std::size_t bytes;
+    if(text != text_last) {
+      RandomAccessIterator chunk_last =
+          text + std::min<std::size_t>(text_last - text, chunk);
+      bytes = d.append(text, chunk_last, errh);
+      text  = chunk_last;
+    } else {
+      bytes    = d.resolve();
+      resolved = true;
+    }
+
+    std::size_t dropped = std::min(skip, bytes);
+    std::size_t count   = std::min(bytes - dropped, remains);
+    out = std::copy(
+        buffer.data() + dropped, buffer.data() + dropped + count, out);
+    skip -= dropped;
+    remains -= count;
+    written += count;
+  }
+  return written;
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Decodes only bytes [byte_first, byte_last) of the data encoded by the text
+// [first, last), reading just the segments that hold them. As segments are
+// a fixed size, where they start in the text is worked out directly, so the
+// cost depends on the size of the range, not of the text. Returns the number
+// of bytes written, which is less than asked for if the data ends first.
+// Bad input in the segments read throws as decode does.
+//
+// The text must be a single line.
+template <typename RandomAccessIterator, typename OutputIterator, typename Codec>
+std::size_t decode_range(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    std::size_t byte_first,
+    std::size_t byte_last,
+    OutputIterator out,
+    Codec const& codec) {
+  decode_error_handler_throw errh(codec);
+  return detail::decode_range(
+      first, byte_first, byte_last, out, codec,
+      detail::unwrapped_positions(last - first), errh);
+}
+
+// As above, for text wrapped into lines as encode wraps it with wrapping.
+template <typename RandomAccessIterator, typename OutputIterator, typename Codec>
+std::size_t decode_range(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    std::size_t byte_first,
+    std::size_t byte_last,
+    OutputIterator out,
+    Codec const& codec,
+    line_wrapping wrapping) {
+  if(!wrapping.enabled())
+    return decode_range(first, last, byte_first, byte_last, out, codec);
+
+  decode_error_handler_skip_whitespace errh(codec);
+  return detail::decode_range(
+      first, byte_first, byte_last, out, codec,
+      detail::wrapped_positions(wrapping, last - first), errh);
+}
+
+// As above, for text with lines of any length, located with an index built
+// from the same text.
+template <typename RandomAccessIterator, typename OutputIterator, typename Codec>
+std::size_t decode_range(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    std::size_t byte_first,
+    std::size_t byte_last,
+    OutputIterator out,
+    Codec const& codec,
+    line_index const& index) {
+  BOOST_ASSERT(index.position(index.symbols()) == std::size_t(last - first));
+  boost::ignore_unused(last);
+  decode_error_handler_skip_whitespace errh(codec);
+  return detail::decode_range(
+      first, byte_first, byte_last, out, codec, index, errh);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_DECODERANGE_HPP
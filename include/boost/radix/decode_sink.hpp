@@ -0,0 +1,208 @@
+//
+// boost/radix/decode_sink.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DECODESINK_HPP
+#define BOOST_RADIX_DECODESINK_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_validation.hpp>
+
+#include <boost/array.hpp>
+
+#include <algorithm>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+namespace detail {
+
+// Size of the buffer decoded output is gathered in before it is passed on.
+std::size_t const decode_sink_buffer_size = 4096;
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Decodes into a sink, a callable taking (bits_type const*, std::size_t),
+// instead of an output iterator. Output is gathered in a buffer inside the
+// decoder and passed on a buffer at a time, so the sink is called once per
+// few KiB rather than per byte and nothing the size of the output is
+// allocated. The data passed to the sink is only valid during the call.
+//
+// The sink is held by value. Use a reference wrapper, or
+// make_accumulator_sink, to keep state such as a hash outside.
+template <typename Codec, typename Sink>
+class sink_decoder {
+ public:
+  typedef Codec codec_type;
+
+  sink_decoder(Codec const& codec, Sink sink)
+      : codec_(codec)
+      , decoder_(codec, buffer_.data())
+      , sink_(sink)
+      , aborted_(false) {
+  }
+
+  template <typename Iterator, typename EndIterator>
+  std::size_t append(Iterator first, EndIterator last) {
+    decode_error_handler_throw errh(codec_);
+    return append(first, last, errh);
+  }
+
+  // Contiguous input is decoded a chunk at a time, sized so the output of
+  // each fits the buffer. If the handler aborts, the whole segments before
+  // the error are passed on, the last of them resolved as it may be padded,
+  // and the rest of the input, anything appended later and any partial
+  // segment are dropped.
+  template <typename ErrorHandler>
+  std::size_t append(
+      char_type const* first, char_type const* last, ErrorHandler& errh) {
+    std::size_t bytes_appended = 0;
+    while(first != last && !aborted_) {
+      char_type const* chunk_last =
+          first + std::min<std::ptrdiff_t>(last - first, chunk_size);
+      decoder_.redirect(buffer_.data());
+      std::size_t bytes = decoder_.append_until_error(first, chunk_last, errh);
+      aborted_ = first != chunk_last;
+      if(aborted_)
+        bytes += decoder_.flush();
+      bytes_appended += pass_on(bytes);
+    }
+    return bytes_appended;
+  }
+
+  template <typename ErrorHandler>
+  std::size_t
+  append(char_type* first, char_type* last, ErrorHandler& errh) {
+    return append(
+        static_cast<char_type const*>(first),
+        static_cast<char_type const*>(last), errh);
+  }
+
+  // Other input is copied out a chunk at a time.
+  template <typename Iterator, typename EndIterator, typename ErrorHandler>
+  std::size_t append(Iterator first, EndIterator last, ErrorHandler& errh) {
+    boost::array<char_type, chunk_size> chars;
+    std::size_t bytes_appended = 0;
+    while(first != last && !aborted_) {
+      std::size_t count = 0;
+      for(; count < chars.size() && first != last; ++first)
+        chars[count++] = *first;
+      char_type const* data = chars.data();
+      bytes_appended += append(data, data + count, errh);
+    }
+    return bytes_appended;
+  }
+
+  std::size_t resolve() {
+    if(aborted_)
+      return 0;
+    decoder_.redirect(buffer_.data());
+    return pass_on(decoder_.resolve());
+  }
+
+  std::size_t bytes_written() const {
+    return decoder_.bytes_written();
+  }
+
+  Sink const& sink() const {
+    return sink_;
+  }
+
+ private:
+  // A chunk and the segment held back from the one before decode to at most
+  // the size of the buffer.
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      chunk_size =
+          detail::decode_sink_buffer_size /
+              codec_traits::packed_segment_size<Codec>::value *
+              codec_traits::unpacked_segment_size<Codec>::value -
+          codec_traits::unpacked_segment_size<Codec>::value);
+
+  std::size_t pass_on(std::size_t bytes) {
+    if(bytes)
+      sink_(buffer_.data(), bytes);
+    return bytes;
+  }
+
+  Codec const& codec_;
+  boost::array<bits_type, detail::decode_sink_buffer_size> buffer_;
+  decoder<Codec, bits_type*> decoder_;
+  Sink sink_;
+  bool aborted_;
+};
+
+// -----------------------------------------------------------------------------
+// A sink that passes decoded output to an accumulator with a
+// process_bytes(void const*, std::size_t) member, such as boost::crc_optimal
+// or crc32c, which is held by reference.
+template <typename Accumulator>
+class accumulator_sink {
+ public:
+  explicit accumulator_sink(Accumulator& acc)
+      : acc_(&acc) {
+  }
+
+  void operator()(bits_type const* data, std::size_t size) const {
+    acc_->process_bytes(data, size);
+  }
+
+ private:
+  Accumulator* acc_;
+};
+
+template <typename Accumulator>
+accumulator_sink<Accumulator> make_accumulator_sink(Accumulator& acc) {
+  return accumulator_sink<Accumulator>(acc);
+}
+
+// -----------------------------------------------------------------------------
+// Decodes [first, last) into sink. Returns the number of bytes passed to it.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename Sink,
+    typename Codec>
+std::size_t decode_to_sink(
+    InputIterator first, InputEndIterator last, Sink sink, Codec const& codec) {
+  sink_decoder<Codec, Sink> d(codec, sink);
+  d.append(first, last);
+  d.resolve();
+  return d.bytes_written();
+}
+
+// Decodes using a user supplied error handler, such as
+// decode_error_handler_skip_whitespace for line wrapped input.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename Sink,
+    typename Codec,
+    typename ErrorHandler>
+std::size_t decode_to_sink(
+    InputIterator first,
+    InputEndIterator last,
+    Sink sink,
+    Codec const& codec,
+    ErrorHandler& errh) {
+  sink_decoder<Codec, Sink> d(codec, sink);
+  d.append(first, last, errh);
+  d.resolve();
+  return d.bytes_written();
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_DECODESINK_HPP
@@ -0,0 +1,321 @@
+//
+// boost/radix/decode_validation.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DECODEVALIDATION_HPP
+#define BOOST_RADIX_DECODEVALIDATION_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/exception.hpp>
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+#  include <boost/system/error_code.hpp>
+#endif
+
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <cctype>
+#include <string>
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+#  include <system_error>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace decode_validation {
+
+enum op {
+  op_consume,
+  op_skip,
+  op_abort,
+};
+
+enum error {
+  none = 0,
+  invalid_whitespace,
+  nonalphabet_character,
+  invalid_padding,
+  incomplete_segment,
+};
+
+}}} // namespace boost::radix::decode_validation
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+namespace std {
+template <>
+struct is_error_code_enum<boost::radix::decode_validation::error>
+    : true_type {};
+} // namespace std
+#endif // BOOST_RADIX_SUPPORT_STDERRORCODE
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+namespace boost { namespace system {
+template <>
+struct is_error_code_enum<boost::radix::decode_validation::error> {
+  static const bool value = true;
+};
+}}     // namespace boost::system
+#endif // BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+
+namespace boost { namespace radix { namespace decode_validation {
+
+inline char const* error_message(int e) {
+  switch(e) {
+  case none:
+    return "success";
+  case invalid_whitespace:
+    return "whitespace in encoded input";
+  case nonalphabet_character:
+    return "character not in the codec's alphabet";
+  case invalid_padding:
+    return "padding before the end of the encoded input";
+  case incomplete_segment:
+    return "encoded input ends part way through a byte";
+  }
+  return "unknown decode error";
+}
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+class boost_error_category : public boost::system::error_category {
+ public:
+  char const* name() const BOOST_NOEXCEPT {
+    return "boost.radix.decode";
+  }
+
+  std::string message(int e) const {
+    return error_message(e);
+  }
+};
+
+inline boost::system::error_category const& get_boost_error_category() {
+  static boost_error_category const category;
+  return category;
+}
+#endif // BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+class std_error_category : public std::error_category {
+ public:
+  char const* name() const BOOST_NOEXCEPT {
+    return "boost.radix.decode";
+  }
+
+  std::string message(int e) const {
+    return error_message(e);
+  }
+};
+
+inline std::error_category const& get_std_error_category() {
+  static std_error_category const category;
+  return category;
+}
+#endif // BOOST_RADIX_SUPPORT_STDERRORCODE
+
+// Both boost::system and std find make_error_code through adl on the enum,
+// so the one overload returns a value that converts to either kind of error
+// code, each with its own category.
+class error_code_value {
+ public:
+  explicit error_code_value(error e)
+      : error_(e) {
+  }
+
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+  operator boost::system::error_code() const {
+    return boost::system::error_code(
+        static_cast<int>(error_), get_boost_error_category());
+  }
+#endif
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+  operator std::error_code() const {
+    return std::error_code(static_cast<int>(error_), get_std_error_category());
+  }
+#endif
+
+ private:
+  error error_;
+};
+
+inline error_code_value make_error_code(error e) {
+  return error_code_value(e);
+}
+
+}}} // namespace boost::radix::decode_validation
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+//
+namespace adl {
+
+template <typename Codec>
+bool is_invalid_whitespace_character(Codec const& codec, char_type c) {
+  if(std::isspace(c)) {
+    return true;
+  }
+  return false;
+}
+
+template <typename Codec, typename ErrorHandler>
+decode_validation::op validate_character(
+    Codec const& codec, char_type c, ErrorHandler& errh) {
+  if(is_invalid_whitespace_character(codec, c))
+    return errh.handle_whitespace_character(codec, c);
+  if(!codec.has_char(c))
+    return errh.handle_nonalphabet_character(codec, c);
+  return decode_validation::op_consume;
+}
+
+} // namespace adl
+
+struct decode_error_handler_throw {
+  template <typename Codec>
+  decode_error_handler_throw(Codec const&) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
+    BOOST_THROW_EXCEPTION(invalid_whitespace(c));
+    return decode_validation::op_consume;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(
+      Codec const& codec, char_type c) {
+    BOOST_THROW_EXCEPTION(nonalphabet_character(c));
+    return decode_validation::op_consume;
+  }
+};
+
+template <typename ErrorCodeType>
+struct decode_error_handler_error_code {
+  template <typename Codec>
+  decode_error_handler_error_code(Codec const&, ErrorCodeType& errc)
+      : errc_(errc) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
+    errc_ = decode_validation::invalid_whitespace;
+    return decode_validation::op_abort;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(
+      Codec const& codec, char_type c) {
+    errc_ = decode_validation::nonalphabet_character;
+    return decode_validation::op_abort;
+  }
+
+  ErrorCodeType& errc_;
+};
+
+struct decode_error_handler_assert {
+  template <typename Codec>
+  decode_error_handler_assert(Codec const&) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
+    BOOST_ASSERT(false);
+    return decode_validation::op_consume;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(
+      Codec const& codec, char_type c) {
+    BOOST_ASSERT(false);
+    return decode_validation::op_consume;
+  }
+};
+
+struct decode_error_handler_ignore {
+  template <typename Codec>
+  decode_error_handler_ignore(Codec const&) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type c) {
+    return decode_validation::op_consume;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(
+      Codec const& codec, char_type c) {
+    return decode_validation::op_consume;
+  }
+};
+
+// Skips whitespace, such as the line breaks in MIME or PEM encoded data, and
+// throws on any other character that is not in the alphabet.
+struct decode_error_handler_skip_whitespace {
+  template <typename Codec>
+  decode_error_handler_skip_whitespace(Codec const&) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type) {
+    return decode_validation::op_skip;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(
+      Codec const&, char_type c) {
+    BOOST_THROW_EXCEPTION(nonalphabet_character(c));
+    return decode_validation::op_consume;
+  }
+};
+
+// As above, but reports the other characters through an error code instead
+// of throwing.
+template <typename ErrorCodeType>
+struct decode_error_handler_skip_whitespace_error_code {
+  template <typename Codec>
+  decode_error_handler_skip_whitespace_error_code(
+      Codec const&, ErrorCodeType& errc)
+      : errc_(errc) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type) {
+    return decode_validation::op_skip;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(Codec const&, char_type) {
+    errc_ = decode_validation::nonalphabet_character;
+    return decode_validation::op_abort;
+  }
+
+  ErrorCodeType& errc_;
+};
+
+// Error handlers that always return op_skip from handle_whitespace_character,
+// and have no other side effects when doing so, can specialise this to let
+// the decoder drop whitespace in bulk without calling the handler.
+template <typename ErrorHandler>
+struct error_handler_skips_whitespace : boost::false_type {};
+
+template <>
+struct error_handler_skips_whitespace<decode_error_handler_skip_whitespace>
+    : boost::true_type {};
+
+template <typename ErrorCodeType>
+struct error_handler_skips_whitespace<
+    decode_error_handler_skip_whitespace_error_code<ErrorCodeType> >
+    : boost::true_type {};
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_DECODEVALIDATION_HPP
@@ -0,0 +1,125 @@
+//
+// boost/radix/detail/alphabet_translator.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_ALPHABETTRANSLATOR_HPP
+#define BOOST_RADIX_DETAIL_ALPHABETTRANSLATOR_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/detail/char_classifier.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/simd.hpp>
+#include <boost/radix/detail/symbol_table.hpp>
+
+#include <boost/array.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+// -----------------------------------------------------------------------------
+// Maps the characters of one alphabet to the characters with the same bits
+// in another, for codecs that pack the same number of bits per character.
+// When only a few characters differ, as between base64 and base64url, a
+// block is translated with a compare and blend per differing character.
+// Otherwise each character is looked up in a table.
+template <typename FromCodec, typename ToCodec>
+class alphabet_translator {
+ public:
+  BOOST_STATIC_CONSTANT(std::size_t, block_size = 32);
+
+  alphabet_translator(FromCodec const& from, ToCodec const& to)
+      : num_changed_(0) {
+    char_classifier<FromCodec> classifier(from);
+    symbols_ = make_alphabet_char_set(classifier);
+    for(int i = 0; i < 256; ++i) {
+      char_type c = static_cast<char_type>(i);
+      table_[i]   = c;
+      if(classifier.classify(c) != char_class_alphabet)
+        continue;
+
+      bits_type bits = from.bits_from_char(c);
+      table_[i] = bits == from.get_pad_bits() ? to.get_pad_char()
+                                              : to.char_from_bits(bits);
+      if(table_[i] != c) {
+        if(num_changed_ < changed_from_.size()) {
+          changed_from_[num_changed_] = c;
+          changed_to_[num_changed_]   = table_[i];
+        }
+        ++num_changed_;
+      }
+    }
+  }
+
+  // True if c is in the source alphabet, including the pad character.
+  bool contains(char_type c) const {
+    return symbols_.contains(c);
+  }
+
+  char_type translate(char_type c) const {
+    return table_[static_cast<unsigned char>(c)];
+  }
+
+  // Translates the block_size characters at in to out. Returns false, with
+  // out in an unspecified state, if any of them is not in the source
+  // alphabet.
+  bool translate_block(char_type const* in, char_type* out) const {
+    if(!symbols_.all(in))
+      return false;
+#if BOOST_RADIX_SIMD_SSE2
+    if(num_changed_ <= changed_from_.size()) {
+      translate_block_simd(in, out);
+      return true;
+    }
+#endif
+    for(std::size_t i = 0; i < block_size; ++i)
+      out[i] = translate(in[i]);
+    return true;
+  }
+
+ private:
+#if BOOST_RADIX_SIMD_SSE2
+  void translate_block_simd(char_type const* in, char_type* out) const {
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i chars  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in));
+    __m256i result = chars;
+    for(std::size_t i = 0; i < num_changed_; ++i) {
+      __m256i hit = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(changed_from_[i]));
+      result = _mm256_blendv_epi8(result, _mm256_set1_epi8(changed_to_[i]), hit);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+#  else
+    for(std::size_t half = 0; half < block_size; half += 16) {
+      __m128i chars =
+          _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + half));
+      __m128i result = chars;
+      for(std::size_t i = 0; i < num_changed_; ++i) {
+        __m128i hit = _mm_cmpeq_epi8(chars, _mm_set1_epi8(changed_from_[i]));
+        result      = _mm_or_si128(
+            _mm_andnot_si128(hit, result),
+            _mm_and_si128(hit, _mm_set1_epi8(changed_to_[i])));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + half), result);
+    }
+#  endif
+  }
+#endif
+
+  char_set symbols_;
+  boost::array<char_type, 256> table_;
+  boost::array<char_type, 8> changed_from_;
+  boost::array<char_type, 8> changed_to_;
+  std::size_t num_changed_;
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_ALPHABETTRANSLATOR_HPP
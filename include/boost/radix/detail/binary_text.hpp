@@ -0,0 +1,156 @@
+//
+// boost/radix/detail/binary_text.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_BINARYTEXT_HPP
+#define BOOST_RADIX_DETAIL_BINARYTEXT_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/cstdint.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#if BOOST_RADIX_SIMD_SSSE3
+
+namespace boost { namespace radix { namespace detail {
+
+// -----------------------------------------------------------------------------
+// Converts between bytes and the text of a 1 bit codec, one character per
+// bit with the most significant first, without going through symbols.
+// Encoding broadcasts each byte across 8 lanes, tests one bit per lane and
+// selects between the two characters. Decoding compares with the character
+// for 1, reverses each group of 8 lanes and gathers the result with a
+// movemask, checking against both characters on the way.
+class binary_text {
+ public:
+  // The characters that encode 32 bits.
+  BOOST_STATIC_CONSTANT(std::size_t, block_size = 32);
+
+  binary_text(char_type zero, char_type one)
+      : zero_(zero)
+      , one_(one) {
+  }
+
+  // Writes the 8 * count characters for count bytes.
+  void to_chars(
+      bits_type const* bytes, std::size_t count, char_type* out) const {
+    char_type const flip = char_type(zero_ ^ one_);
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i const bits = _mm256_setr_epi8(
+        -128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1, -128, 64,
+        32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    __m256i const zeros = _mm256_set1_epi8(zero_);
+    __m256i const flips = _mm256_set1_epi8(flip);
+    __m256i spread =
+        _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2,
+                         2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    for(; count >= 16; count -= 16, bytes += 16) {
+      __m256i source = _mm256_broadcastsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes)));
+      __m256i control = spread;
+      for(int i = 0; i < 4; ++i) {
+        __m256i set = _mm256_cmpeq_epi8(
+            _mm256_and_si256(_mm256_shuffle_epi8(source, control), bits),
+            bits);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out),
+            _mm256_xor_si256(zeros, _mm256_and_si256(set, flips)));
+        control = _mm256_add_epi8(control, _mm256_set1_epi8(4));
+        out += 32;
+      }
+    }
+#  else
+    __m128i const bits = _mm_setr_epi8(
+        -128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+    __m128i const zeros = _mm_set1_epi8(zero_);
+    __m128i const flips = _mm_set1_epi8(flip);
+    __m128i const spread =
+        _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    for(; count >= 16; count -= 16, bytes += 16) {
+      __m128i source = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+      __m128i control = spread;
+      for(int i = 0; i < 8; ++i) {
+        __m128i set = _mm_cmpeq_epi8(
+            _mm_and_si128(_mm_shuffle_epi8(source, control), bits), bits);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out),
+            _mm_xor_si128(zeros, _mm_and_si128(set, flips)));
+        control = _mm_add_epi8(control, _mm_set1_epi8(2));
+        out += 16;
+      }
+    }
+#  endif
+
+    for(; count; --count, ++bytes) {
+      for(int i = 7; i >= 0; --i)
+        *out++ = (*bytes >> i) & 1 ? one_ : zero_;
+    }
+  }
+
+  // Writes the 4 bytes for block_size characters, or returns false if any
+  // of them is not one of the two characters.
+  bool to_bytes(char_type const* block, bits_type* out) const {
+    boost::uint32_t set;
+    boost::uint32_t valid;
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i const reverse = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2,
+        1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    __m256i ones  = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(one_));
+    __m256i zeros = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(zero_));
+    valid = boost::uint32_t(
+        _mm256_movemask_epi8(_mm256_or_si256(ones, zeros)));
+    set = boost::uint32_t(
+        _mm256_movemask_epi8(_mm256_shuffle_epi8(ones, reverse)));
+#  else
+    __m128i const reverse =
+        _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m128i const one  = _mm_set1_epi8(one_);
+    __m128i const zero = _mm_set1_epi8(zero_);
+    __m128i low  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block));
+    __m128i high =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16));
+    __m128i low_ones  = _mm_cmpeq_epi8(low, one);
+    __m128i high_ones = _mm_cmpeq_epi8(high, one);
+    __m128i low_valid = _mm_or_si128(low_ones, _mm_cmpeq_epi8(low, zero));
+    __m128i high_valid = _mm_or_si128(high_ones, _mm_cmpeq_epi8(high, zero));
+    valid = boost::uint32_t(_mm_movemask_epi8(low_valid)) |
+            boost::uint32_t(_mm_movemask_epi8(high_valid)) << 16;
+    set = boost::uint32_t(
+              _mm_movemask_epi8(_mm_shuffle_epi8(low_ones, reverse))) |
+          boost::uint32_t(
+              _mm_movemask_epi8(_mm_shuffle_epi8(high_ones, reverse)))
+              << 16;
+#  endif
+    if(valid != ~boost::uint32_t(0))
+      return false;
+
+    out[0] = bits_type(set);
+    out[1] = bits_type(set >> 8);
+    out[2] = bits_type(set >> 16);
+    out[3] = bits_type(set >> 24);
+    return true;
+  }
+
+ private:
+  char_type zero_;
+  char_type one_;
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_SIMD_SSSE3
+
+#endif // BOOST_RADIX_DETAIL_BINARYTEXT_HPP
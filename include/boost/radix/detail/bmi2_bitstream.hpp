@@ -0,0 +1,173 @@
+//
+// boost/radix/detail/bmi2_bitstream.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_BMI2BITSTREAM_HPP
+#define BOOST_RADIX_DETAIL_BMI2BITSTREAM_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/bitmask.hpp>
+#include <boost/radix/codec_traits/bit_order.hpp>
+#include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <cpuid.h>
+#include <cstring>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#if BOOST_RADIX_SIMD_BMI2
+
+namespace boost { namespace radix { namespace detail {
+
+// -----------------------------------------------------------------------------
+// A binary built with -mbmi2 for a generic x86-64 target can still run on AMD
+// before Zen 3, or on Hygon, where pdep and pext are microcoded and take
+// hundreds of cycles. The vendor and family are read once when the program
+// starts, and the scalar code is used on those parts.
+inline bool has_fast_pdep() {
+  unsigned int eax, ebx, ecx, edx;
+  if(!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+    return false;
+
+  // "AuthenticAMD" and "HygonGenuine", split across ebx, edx and ecx.
+  bool const amd = ebx == 0x68747541 && edx == 0x69746e65 && ecx == 0x444d4163;
+  bool const hygon =
+      ebx == 0x6f677948 && edx == 0x6e65476e && ecx == 0x656e6975;
+  if(!amd && !hygon)
+    return true;
+
+  if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+
+  unsigned int family = (eax >> 8) & 0xF;
+  if(family == 0xF)
+    family += (eax >> 20) & 0xFF;
+
+  // Zen 3 is family 19h.
+  return family >= 0x19;
+}
+
+// Holds the result of has_fast_pdep. It reads as false until it has been
+// initialised, so any use from another static initialiser takes the scalar
+// path.
+template <typename Tag = void>
+struct bmi2_dispatch {
+  static bool const fast;
+};
+
+template <typename Tag>
+bool const bmi2_dispatch<Tag>::fast = has_fast_pdep();
+
+// -----------------------------------------------------------------------------
+// Unpacks and packs one segment with a single pdep or pext. An LSB first
+// segment is a little endian word with its first symbol in the low bits, so
+// pdep spreads the symbols straight out to a byte each. An MSB first segment
+// is read as a big endian word, which leaves its first symbol in the top
+// bits and the last in the lowest byte once spread, so a byte swap puts them
+// in order. Packing is the same in reverse with pext.
+template <std::size_t Bits, bit_order Order>
+class bmi2_bitstream {
+ public:
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      packed_segment_size = bits::to_packed_segment_size<Bits>::value);
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      unpacked_segment_size = bits::to_unpacked_segment_size<Bits>::value);
+
+  BOOST_STATIC_ASSERT(unpacked_segment_size <= sizeof(boost::uint64_t));
+
+  // MSB first widths that divide a byte unpack with a few shifts and no
+  // carries, and are left to the shift ladders. The LSB first scalar code is
+  // a generic loop, which is slower than a pdep at every width.
+  BOOST_STATIC_CONSTANT(
+      bool,
+      preferred =
+          Order == bit_order_lsb_first || 8 % Bits != 0 || Bits == 1);
+
+  // symbols are any one byte type.
+  static void unpack(bits_type const* packed, void* symbols) {
+    boost::uint64_t spread;
+    if(Order == bit_order_msb_first) {
+      spread = __builtin_bswap64(
+                   _pdep_u64(read_big_endian(packed), symbol_mask())) >>
+               (64 - 8 * unpacked_segment_size);
+    } else {
+      spread = _pdep_u64(read_little_endian(packed), symbol_mask());
+    }
+    std::memcpy(symbols, &spread, unpacked_segment_size);
+  }
+
+  static void pack(void const* symbols, bits_type* packed) {
+    boost::uint64_t spread = 0;
+    std::memcpy(&spread, symbols, unpacked_segment_size);
+    boost::uint64_t word;
+    if(Order == bit_order_msb_first) {
+      spread = __builtin_bswap64(spread) >> (64 - 8 * unpacked_segment_size);
+      word   = __builtin_bswap64(
+          _pext_u64(spread, symbol_mask()) << (64 - 8 * packed_segment_size));
+    } else {
+      word = _pext_u64(spread, symbol_mask());
+    }
+    std::memcpy(packed, &word, packed_segment_size);
+  }
+
+ private:
+  // Reads the segment with a 4 byte load and single bytes, all in registers.
+  // Gathering it through memory stalls on the partial stores, and 2 byte
+  // loads make each segment wait on the last through the register they
+  // merge into.
+  static boost::uint64_t read_big_endian(bits_type const* packed) {
+    boost::uint64_t word = 0;
+    std::size_t const size = packed_segment_size;
+    std::size_t i          = 0;
+    if(size >= 4) {
+      boost::uint32_t part;
+      std::memcpy(&part, packed, 4);
+      word = __builtin_bswap32(part);
+      i    = 4;
+    }
+    for(; i < size; ++i)
+      word = (word << 8) | packed[i];
+    return word;
+  }
+
+  static boost::uint64_t read_little_endian(bits_type const* packed) {
+    boost::uint64_t word = 0;
+    std::size_t const size = packed_segment_size;
+    std::size_t i          = 0;
+    if(size >= 4) {
+      boost::uint32_t part;
+      std::memcpy(&part, packed, 4);
+      word = part;
+      i    = 4;
+    }
+    for(; i < size; ++i)
+      word |= boost::uint64_t(packed[i]) << (8 * i);
+    return word;
+  }
+
+  // The low Bits of each of the first unpacked_segment_size bytes.
+  static boost::uint64_t symbol_mask() {
+    return (~boost::uint64_t(0) >> (64 - 8 * unpacked_segment_size)) / 0xFF *
+           mask<Bits>::value;
+  }
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_SIMD_BMI2
+
+#endif // BOOST_RADIX_DETAIL_BMI2BITSTREAM_HPP
@@ -0,0 +1,202 @@
+//
+// boost/radix/detail/char_classifier.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_CHARCLASSIFIER_HPP
+#define BOOST_RADIX_DETAIL_CHARCLASSIFIER_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/array.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+enum char_class {
+  char_class_alphabet,
+  char_class_whitespace,
+  char_class_nonalphabet,
+};
+
+// Error handler that records which class validate_character put a character
+// in, without any of the side effects of the real handlers.
+struct char_class_probe {
+  char_class_probe()
+      : result(char_class_alphabet) {
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_whitespace_character(Codec const&, char_type) {
+    result = char_class_whitespace;
+    return decode_validation::op_skip;
+  }
+
+  template <typename Codec>
+  decode_validation::op handle_nonalphabet_character(Codec const&, char_type) {
+    result = char_class_nonalphabet;
+    return decode_validation::op_abort;
+  }
+
+  char_class result;
+};
+
+// Building a char_classifier, and the tables made from one, costs a
+// validate_character call per character value, so inputs shorter than this
+// are handled one character at a time instead.
+std::size_t const char_classifier_threshold = 256;
+
+// -----------------------------------------------------------------------------
+// Classifies every character once up front by running it through the codec's
+// validate_character, so any adl customisations are honoured, and then
+// answers bulk queries over ranges from a table. When the codec has only a
+// handful of whitespace characters they are matched with vector compares.
+template <typename Codec>
+class char_classifier {
+ public:
+  explicit char_classifier(Codec const& codec)
+      : num_whitespace_(0) {
+    for(int i = 0; i < 256; ++i) {
+      char_type c = static_cast<char_type>(i);
+      char_class_probe probe;
+      using boost::radix::adl::validate_character;
+      validate_character(codec, c, probe);
+      classes_[i] = static_cast<unsigned char>(probe.result);
+      if(probe.result == char_class_whitespace) {
+        if(num_whitespace_ < whitespace_.size())
+          whitespace_[num_whitespace_] = c;
+        ++num_whitespace_;
+      }
+    }
+  }
+
+  char_class classify(char_type c) const {
+    return static_cast<char_class>(classes_[static_cast<unsigned char>(c)]);
+  }
+
+  bool is_whitespace(char_type c) const {
+    return classify(c) == char_class_whitespace;
+  }
+
+  // Number of whitespace characters in [first, last).
+  template <typename Iterator>
+  std::size_t count_whitespace(Iterator first, Iterator last) const {
+    std::size_t count = 0;
+    for(; first != last; ++first)
+      count += is_whitespace(*first);
+    return count;
+  }
+
+  std::size_t count_whitespace(
+      char_type const* first, char_type const* last) const {
+    if(!num_whitespace_)
+      return 0;
+    std::size_t count = 0;
+    if(num_whitespace_ <= whitespace_.size())
+      first = count_whitespace_simd(first, last, count);
+    return count + count_whitespace<char_type const*>(first, last);
+  }
+
+  std::size_t count_whitespace(char_type* first, char_type* last) const {
+    return count_whitespace(
+        static_cast<char_type const*>(first),
+        static_cast<char_type const*>(last));
+  }
+
+  // Bit mask of the whitespace characters in the 32 characters at block.
+  boost::uint32_t whitespace_mask(char_type const* block) const {
+#if BOOST_RADIX_SIMD_SSE2
+    if(num_whitespace_ <= whitespace_.size())
+      return whitespace_mask_simd(block);
+#endif
+    boost::uint32_t mask = 0;
+    for(std::size_t i = 0; i < 32; ++i)
+      mask |= boost::uint32_t(is_whitespace(block[i])) << i;
+    return mask;
+  }
+
+  // Advances past count non-whitespace characters, returning the position
+  // immediately after the last of them.
+  template <typename Iterator>
+  Iterator skip_symbols(Iterator first, Iterator last, std::size_t count) const {
+    for(; count && first != last; ++first) {
+      if(!is_whitespace(*first))
+        --count;
+    }
+    return first;
+  }
+
+ private:
+#if BOOST_RADIX_SIMD_SSE2
+  boost::uint32_t whitespace_mask_simd(char_type const* block) const {
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    __m256i matches = _mm256_setzero_si256();
+    for(std::size_t i = 0; i < num_whitespace_; ++i) {
+      matches = _mm256_or_si256(
+          matches, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(whitespace_[i])));
+    }
+    return static_cast<boost::uint32_t>(_mm256_movemask_epi8(matches));
+#  else
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16));
+    __m128i lo_matches = _mm_setzero_si128();
+    __m128i hi_matches = _mm_setzero_si128();
+    for(std::size_t i = 0; i < num_whitespace_; ++i) {
+      __m128i ws = _mm_set1_epi8(whitespace_[i]);
+      lo_matches = _mm_or_si128(lo_matches, _mm_cmpeq_epi8(lo, ws));
+      hi_matches = _mm_or_si128(hi_matches, _mm_cmpeq_epi8(hi, ws));
+    }
+    return static_cast<boost::uint32_t>(_mm_movemask_epi8(lo_matches)) |
+           (static_cast<boost::uint32_t>(_mm_movemask_epi8(hi_matches)) << 16);
+#  endif
+  }
+#endif
+
+  char_type const* count_whitespace_simd(
+      char_type const* first, char_type const* last, std::size_t& count) const {
+#if BOOST_RADIX_SIMD_AVX2
+    for(; last - first >= 32; first += 32) {
+      __m256i block =
+          _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+      __m256i matches = _mm256_setzero_si256();
+      for(std::size_t i = 0; i < num_whitespace_; ++i) {
+        matches = _mm256_or_si256(
+            matches,
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8(whitespace_[i])));
+      }
+      count += popcount(_mm256_movemask_epi8(matches));
+    }
+#endif
+#if BOOST_RADIX_SIMD_SSE2
+    for(; last - first >= 16; first += 16) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+      __m128i matches = _mm_setzero_si128();
+      for(std::size_t i = 0; i < num_whitespace_; ++i) {
+        matches = _mm_or_si128(
+            matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(whitespace_[i])));
+      }
+      count += popcount(_mm_movemask_epi8(matches));
+    }
+#endif
+    return first;
+  }
+
+  boost::array<unsigned char, 256> classes_;
+  boost::array<char_type, 8> whitespace_;
+  std::size_t num_whitespace_;
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_CHARCLASSIFIER_HPP
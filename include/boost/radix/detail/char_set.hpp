@@ -0,0 +1,228 @@
+//
+// boost/radix/detail/char_set.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_CHARSET_HPP
+#define BOOST_RADIX_DETAIL_CHARSET_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+// -----------------------------------------------------------------------------
+// An arbitrary set of characters that can be tested 16 or 32 at a time.
+//
+// Characters are split into their high and low nibbles, and the set of low
+// nibbles allowed for each high nibble forms a row. When there are no more
+// than 8 distinct non-empty rows, which covers the RFC 4648 alphabets, each
+// row is given a bit, the high nibble table maps to the bit of its row and
+// the low nibble table to the bits of the rows containing it. A character is
+// then a member if the two pshufb lookups share a bit. Other sets fall back
+// to a table lookup per character.
+class char_set {
+ public:
+  char_set()
+      : vectorizable_(false) {
+    members_.fill(0);
+  }
+
+  explicit char_set(boost::array<bool, 256> const& members)
+      : vectorizable_(false) {
+    for(int i = 0; i < 256; ++i)
+      members_[i] = members[i];
+    build_nibble_tables();
+  }
+
+  bool contains(char_type c) const {
+    return members_[static_cast<unsigned char>(c)] != 0;
+  }
+
+  // Bit mask of the members among the 32 characters at block.
+  boost::uint32_t mask(char_type const* block) const {
+#if BOOST_RADIX_SIMD_SSSE3
+    if(vectorizable_)
+      return mask_simd(block);
+#endif
+    boost::uint32_t mask = 0;
+    for(std::size_t i = 0; i < 32; ++i)
+      mask |= boost::uint32_t(contains(block[i])) << i;
+    return mask;
+  }
+
+  // True if all 32 characters at block are members.
+  bool all(char_type const* block) const {
+#if BOOST_RADIX_SIMD_SSSE3
+    if(vectorizable_)
+      return mask_simd(block) == ~boost::uint32_t(0);
+#endif
+    unsigned char all = 1;
+    for(std::size_t i = 0; i < 32; ++i)
+      all &= members_[static_cast<unsigned char>(block[i])];
+    return all != 0;
+  }
+
+  // Number of members in [first, last).
+  std::size_t count(char_type const* first, char_type const* last) const {
+    std::size_t count = 0;
+#if BOOST_RADIX_SIMD_SSSE3
+    if(vectorizable_)
+      first = count_simd(first, last, count);
+#endif
+    for(; first != last; ++first)
+      count += contains(*first);
+    return count;
+  }
+
+ private:
+  void build_nibble_tables() {
+    boost::array<boost::uint16_t, 16> rows;
+    rows.fill(0);
+    for(int i = 0; i < 256; ++i) {
+      if(members_[i])
+        rows[i >> 4] |= boost::uint16_t(1u << (i & 0xF));
+    }
+
+    boost::array<boost::uint16_t, 8> distinct_rows;
+    std::size_t num_distinct = 0;
+    lo_.fill(0);
+    hi_.fill(0);
+    for(std::size_t hi = 0; hi < 16; ++hi) {
+      if(!rows[hi])
+        continue;
+
+      std::size_t bit = std::find(
+                            distinct_rows.begin(),
+                            distinct_rows.begin() + num_distinct, rows[hi]) -
+                        distinct_rows.begin();
+      if(bit == num_distinct) {
+        if(num_distinct == distinct_rows.size())
+          return;
+        distinct_rows[num_distinct++] = rows[hi];
+        for(std::size_t lo = 0; lo < 16; ++lo) {
+          if(rows[hi] & (1u << lo))
+            lo_[lo] |= static_cast<unsigned char>(1u << bit);
+        }
+      }
+      hi_[hi] = static_cast<unsigned char>(1u << bit);
+    }
+
+    vectorizable_ = true;
+  }
+
+#if BOOST_RADIX_SIMD_SSSE3
+  boost::uint32_t mask_simd(char_type const* block) const {
+    __m128i lo_table =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(lo_.data()));
+    __m128i hi_table =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(hi_.data()));
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i lo_table2 = _mm256_broadcastsi128_si256(lo_table);
+    __m256i hi_table2 = _mm256_broadcastsi128_si256(hi_table);
+    __m256i nibble    = _mm256_set1_epi8(0x0F);
+    __m256i chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    __m256i lo    = _mm256_and_si256(chars, nibble);
+    __m256i hi    = _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble);
+    __m256i rows  = _mm256_and_si256(
+        _mm256_shuffle_epi8(lo_table2, lo), _mm256_shuffle_epi8(hi_table2, hi));
+    return ~static_cast<boost::uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(rows, _mm256_setzero_si256())));
+#  else
+    __m128i nibble       = _mm_set1_epi8(0x0F);
+    boost::uint32_t mask = 0;
+    for(int half = 0; half < 2; ++half) {
+      __m128i chars =
+          _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + half * 16));
+      __m128i lo   = _mm_and_si128(chars, nibble);
+      __m128i hi   = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble);
+      __m128i rows = _mm_and_si128(
+          _mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+      boost::uint32_t absent = static_cast<boost::uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(rows, _mm_setzero_si128())));
+      mask |= (~absent & 0xFFFF) << (half * 16);
+    }
+    return mask;
+#  endif
+  }
+
+  // Counts the non-members in byte lanes, which are folded into count before
+  // they can overflow, rather than reducing every block to a mask.
+  char_type const* count_simd(
+      char_type const* first, char_type const* last, std::size_t& count) const {
+    __m128i lo_table =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(lo_.data()));
+    __m128i hi_table =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(hi_.data()));
+#  if BOOST_RADIX_SIMD_AVX2
+    __m256i lo_table2 = _mm256_broadcastsi128_si256(lo_table);
+    __m256i hi_table2 = _mm256_broadcastsi128_si256(hi_table);
+    __m256i nibble    = _mm256_set1_epi8(0x0F);
+    while(last - first >= 32) {
+      std::size_t blocks = std::min<std::size_t>((last - first) / 32, 255);
+      __m256i absent     = _mm256_setzero_si256();
+      for(std::size_t i = 0; i < blocks; ++i, first += 32) {
+        __m256i chars =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+        __m256i lo   = _mm256_and_si256(chars, nibble);
+        __m256i hi   = _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble);
+        __m256i rows = _mm256_and_si256(
+            _mm256_shuffle_epi8(lo_table2, lo),
+            _mm256_shuffle_epi8(hi_table2, hi));
+        absent = _mm256_sub_epi8(
+            absent, _mm256_cmpeq_epi8(rows, _mm256_setzero_si256()));
+      }
+      __m256i sums  = _mm256_sad_epu8(absent, _mm256_setzero_si256());
+      __m128i sums2 = _mm_add_epi64(
+          _mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+      std::size_t missing =
+          _mm_cvtsi128_si32(sums2) + _mm_extract_epi16(sums2, 4);
+      count += blocks * 32 - missing;
+    }
+#  else
+    __m128i nibble = _mm_set1_epi8(0x0F);
+    while(last - first >= 16) {
+      std::size_t blocks = std::min<std::size_t>((last - first) / 16, 255);
+      __m128i absent     = _mm_setzero_si128();
+      for(std::size_t i = 0; i < blocks; ++i, first += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        __m128i lo    = _mm_and_si128(chars, nibble);
+        __m128i hi    = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble);
+        __m128i rows  = _mm_and_si128(
+            _mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+        absent = _mm_sub_epi8(
+            absent, _mm_cmpeq_epi8(rows, _mm_setzero_si128()));
+      }
+      __m128i sums = _mm_sad_epu8(absent, _mm_setzero_si128());
+      std::size_t missing =
+          _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+      count += blocks * 16 - missing;
+    }
+#  endif
+    return first;
+  }
+#endif
+
+  boost::array<unsigned char, 256> members_;
+  boost::array<unsigned char, 16> lo_;
+  boost::array<unsigned char, 16> hi_;
+  bool vectorizable_;
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_CHARSET_HPP
@@ -0,0 +1,146 @@
+//
+// boost/radix/detail/parallel_chunks.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_PARALLELCHUNKS_HPP
+#define BOOST_RADIX_DETAIL_PARALLELCHUNKS_HPP
+
+#include <boost/radix/common.hpp>
+
+#if BOOST_RADIX_SUPPORT_PARALLEL
+
+#  include <boost/noncopyable.hpp>
+
+#  include <atomic>
+#  include <condition_variable>
+#  include <exception>
+#  include <mutex>
+#  include <thread>
+
+#  ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#  endif
+
+namespace boost { namespace radix { namespace detail {
+
+// -----------------------------------------------------------------------------
+// Number of threads an executor runs functions on. One with a size() member,
+// such as thread_pool, reports its own, and any other is assumed to have one
+// per hardware thread.
+template <typename Executor>
+auto executor_concurrency(Executor const& executor, int)
+    -> decltype(std::size_t(executor.size())) {
+  return executor.size();
+}
+
+template <typename Executor>
+std::size_t executor_concurrency(Executor const&, long) {
+  return std::thread::hardware_concurrency();
+}
+
+// -----------------------------------------------------------------------------
+// Runs body(i) for every i in [0, num_chunks) on the calling thread plus up to
+// one worker per executor thread. Chunks are claimed from a shared counter as
+// each worker becomes free, so a slow chunk never holds up the others. The
+// first exception thrown by the body stops further chunks from being claimed
+// and is rethrown on the calling thread, as is one thrown by the executor once
+// the workers it did accept have finished.
+class parallel_chunks : boost::noncopyable {
+ public:
+  explicit parallel_chunks(std::size_t num_chunks)
+      : next_(0)
+      , num_chunks_(num_chunks)
+      , workers_(0) {
+  }
+
+  template <typename Body, typename Executor>
+  void run(Body const& body, Executor& executor) {
+    std::size_t num_workers = executor_concurrency(executor, 0);
+    if(num_workers >= num_chunks_)
+      num_workers = num_chunks_ ? num_chunks_ - 1 : 0;
+
+    for(std::size_t i = 0; i < num_workers; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++workers_;
+      }
+      try {
+        executor.execute(worker<Body>(*this, body));
+      } catch(...) {
+        // The workers already posted still refer to this object and the
+        // body, so they are stopped and waited for before unwinding.
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          --workers_;
+        }
+        next_ = num_chunks_;
+        wait_for_workers();
+        throw;
+      }
+    }
+
+    process(body);
+    wait_for_workers();
+
+    if(error_)
+      std::rethrow_exception(error_);
+  }
+
+ private:
+  template <typename Body>
+  struct worker {
+    worker(parallel_chunks& chunks, Body const& body)
+        : chunks_(&chunks)
+        , body_(&body) {
+    }
+
+    void operator()() const {
+      chunks_->process(*body_);
+      std::lock_guard<std::mutex> lock(chunks_->mutex_);
+      if(--chunks_->workers_ == 0)
+        chunks_->done_.notify_all();
+    }
+
+    parallel_chunks* chunks_;
+    Body const* body_;
+  };
+
+  void wait_for_workers() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(workers_ != 0)
+      done_.wait(lock);
+  }
+
+  template <typename Body>
+  void process(Body const& body) {
+    std::size_t chunk;
+    while((chunk = next_.fetch_add(1)) < num_chunks_) {
+      try {
+        body(chunk);
+      } catch(...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!error_)
+          error_ = std::current_exception();
+        next_ = num_chunks_;
+      }
+    }
+  }
+
+  std::atomic<std::size_t> next_;
+  std::size_t num_chunks_;
+  std::size_t workers_;
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::exception_ptr error_;
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_SUPPORT_PARALLEL
+
+#endif // BOOST_RADIX_DETAIL_PARALLELCHUNKS_HPP
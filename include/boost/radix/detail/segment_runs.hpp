@@ -0,0 +1,229 @@
+//
+// boost/radix/detail/segment_runs.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_SEGMENTRUNS_HPP
+#define BOOST_RADIX_DETAIL_SEGMENTRUNS_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/bit_order.hpp>
+#include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/vector_bitstream.hpp>
+
+#include <boost/array.hpp>
+
+#include <algorithm>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    typename SegmentUnpacker,
+    typename RandomAccessIterator>
+void unpack_each_segment(
+    SegmentUnpacker const& segment_unpacker,
+    RandomAccessIterator packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  for(; segments; --segments) {
+    boost::array<bits_type, UnpackedSegmentSize> segment;
+    segment_unpacker(packed, segment);
+    symbols = std::copy(segment.begin(), segment.end(), symbols);
+    packed += PackedSegmentSize;
+  }
+}
+
+// Unpacks a run of segments into consecutive symbols. Any unpacker can be
+// used a segment at a time; the library's own unpackers reading from memory
+// go a vector at a time where they can.
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    typename SegmentUnpacker,
+    typename RandomAccessIterator>
+void unpack_segments(
+    SegmentUnpacker const& segment_unpacker,
+    RandomAccessIterator packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_each_segment<PackedSegmentSize, UnpackedSegmentSize>(
+      segment_unpacker, packed, segments, symbols);
+}
+
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    typename SegmentPacker,
+    typename OutputIterator>
+OutputIterator pack_each_segment(
+    SegmentPacker const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    OutputIterator out) {
+  for(; segments; --segments) {
+    out = segment_packer(symbols, out);
+    symbols += UnpackedSegmentSize;
+  }
+  return out;
+}
+
+// Packs a run of consecutive symbols, the counterpart of unpack_segments.
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    typename SegmentPacker,
+    typename OutputIterator>
+OutputIterator pack_segments(
+    SegmentPacker const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    OutputIterator out) {
+  return pack_each_segment<PackedSegmentSize, UnpackedSegmentSize>(
+      segment_packer, symbols, segments, out);
+}
+
+// -----------------------------------------------------------------------------
+// Runs of segments for a segment_unpacker or segment_packer that works in
+// Order, with vector_bitstream when the packed side is in memory and the
+// segment at a time code otherwise.
+template <
+    bit_order Order,
+    std::size_t Bits,
+    typename SegmentUnpacker,
+    typename RandomAccessIterator>
+void unpack_segment_blocks(
+    SegmentUnpacker const& segment_unpacker,
+    RandomAccessIterator packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_each_segment<
+      bits::to_packed_segment_size<Bits>::value,
+      bits::to_unpacked_segment_size<Bits>::value>(
+      segment_unpacker, packed, segments, symbols);
+}
+
+template <
+    bit_order Order,
+    std::size_t Bits,
+    typename SegmentPacker,
+    typename OutputIterator>
+OutputIterator pack_segment_blocks(
+    SegmentPacker const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    OutputIterator out) {
+  return pack_each_segment<
+      bits::to_packed_segment_size<Bits>::value,
+      bits::to_unpacked_segment_size<Bits>::value>(
+      segment_packer, symbols, segments, out);
+}
+
+#if BOOST_RADIX_SIMD_VECTOR_EXTENSIONS
+// Each block loads a whole vector, so the last few segments, which may not
+// be followed by enough bytes, are unpacked one at a time.
+template <bit_order Order, std::size_t Bits, typename SegmentUnpacker>
+void unpack_segment_blocks(
+    SegmentUnpacker const& segment_unpacker,
+    bits_type const* packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  typedef vector_bitstream<Bits, Order> stream_type;
+  if(segments * stream_type::packed_segment_size >= 16) {
+    stream_type const& stream = stream_type::instance();
+    std::size_t const blocks =
+        (segments * stream_type::packed_segment_size - 16) /
+            stream_type::block_bytes +
+        1;
+    for(std::size_t i = 0; i < blocks; ++i) {
+      stream.unpack(packed, symbols);
+      packed += stream_type::block_bytes;
+      symbols += stream_type::block_symbols;
+    }
+    segments -= blocks * stream_type::block_segments;
+  }
+
+  unpack_each_segment<
+      stream_type::packed_segment_size, stream_type::unpacked_segment_size>(
+      segment_unpacker, packed, segments, symbols);
+}
+
+template <bit_order Order, std::size_t Bits, typename SegmentUnpacker>
+void unpack_segment_blocks(
+    SegmentUnpacker const& segment_unpacker,
+    bits_type* packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_segment_blocks<Order, Bits>(
+      segment_unpacker, static_cast<bits_type const*>(packed), segments,
+      symbols);
+}
+
+template <bit_order Order, std::size_t Bits, typename SegmentUnpacker>
+void unpack_segment_blocks(
+    SegmentUnpacker const& segment_unpacker,
+    char_type const* packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_segment_blocks<Order, Bits>(
+      segment_unpacker, reinterpret_cast<bits_type const*>(packed), segments,
+      symbols);
+}
+
+template <bit_order Order, std::size_t Bits, typename SegmentUnpacker>
+void unpack_segment_blocks(
+    SegmentUnpacker const& segment_unpacker,
+    char_type* packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_segment_blocks<Order, Bits>(
+      segment_unpacker, reinterpret_cast<bits_type const*>(packed), segments,
+      symbols);
+}
+
+template <bit_order Order, std::size_t Bits, typename SegmentPacker>
+bits_type* pack_segment_blocks(
+    SegmentPacker const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    bits_type* out) {
+  typedef vector_bitstream<Bits, Order> stream_type;
+  if(stream_type::fast_pack && segments >= stream_type::block_segments) {
+    stream_type const& stream = stream_type::instance();
+    for(; segments >= stream_type::block_segments;
+        segments -= stream_type::block_segments) {
+      stream.pack(symbols, out);
+      symbols += stream_type::block_symbols;
+      out += stream_type::block_bytes;
+    }
+  }
+
+  return pack_each_segment<
+      stream_type::packed_segment_size, stream_type::unpacked_segment_size>(
+      segment_packer, symbols, segments, out);
+}
+
+template <bit_order Order, std::size_t Bits, typename SegmentPacker>
+char_type* pack_segment_blocks(
+    SegmentPacker const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    char_type* out) {
+  return reinterpret_cast<char_type*>(pack_segment_blocks<Order, Bits>(
+      segment_packer, symbols, segments, reinterpret_cast<bits_type*>(out)));
+}
+#endif
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_SEGMENTRUNS_HPP
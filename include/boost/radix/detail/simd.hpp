@@ -0,0 +1,112 @@
+//
+// boost/radix/detail/simd.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_SIMD_HPP
+#define BOOST_RADIX_DETAIL_SIMD_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+
+// -----------------------------------------------------------------------------
+// Vector instruction sets are selected at compile time from the target flags
+// (-msse2, -mavx2, /arch:AVX2, etc). Define BOOST_RADIX_NO_SIMD to force the
+// scalar code paths everywhere.
+#ifndef BOOST_RADIX_NO_SIMD
+#  if defined(__SSE2__) || defined(_M_X64) ||                                  \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define BOOST_RADIX_SIMD_SSE2 1
+#  endif
+#  if defined(__SSSE3__) || defined(__AVX__)
+#    define BOOST_RADIX_SIMD_SSSE3 1
+#  endif
+#  if defined(__SSE4_2__)
+#    define BOOST_RADIX_SIMD_SSE42 1
+#  endif
+#  if defined(__AVX2__)
+#    define BOOST_RADIX_SIMD_AVX2 1
+#  endif
+// pdep and pext are microcoded, and hundreds of cycles, on AMD before Zen 3,
+// so they are left alone when targeting those. A build for a generic target
+// checks the CPU at startup as well (see detail/bmi2_bitstream.hpp). Define
+// BOOST_RADIX_NO_BMI2 to never use them.
+#  if defined(__BMI2__) && defined(__x86_64__) &&                              \
+      !defined(BOOST_RADIX_NO_BMI2) && !defined(__bdver4__) &&                 \
+      !defined(__znver1__) && !defined(__znver2__)
+#    define BOOST_RADIX_SIMD_BMI2 1
+#  endif
+// Generic vector code written with the GCC/Clang vector extensions, which
+// needs a byte shuffle with a variable index to be worth using.
+#  if defined(__clang__)
+#    if defined(__SSSE3__)
+#      define BOOST_RADIX_SIMD_VECTOR_EXTENSIONS 1
+#    endif
+#  elif defined(__GNUC__) && __GNUC__ >= 9
+#    if defined(__SSSE3__) || defined(__aarch64__)
+#      define BOOST_RADIX_SIMD_VECTOR_EXTENSIONS 1
+#    endif
+#  endif
+#endif
+
+#if BOOST_RADIX_SIMD_AVX2 || BOOST_RADIX_SIMD_BMI2
+#  include <immintrin.h>
+#elif BOOST_RADIX_SIMD_SSSE3
+#  include <tmmintrin.h>
+#elif BOOST_RADIX_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if BOOST_RADIX_SIMD_SSE42 && !BOOST_RADIX_SIMD_AVX2
+#  include <nmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+inline std::size_t popcount(boost::uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcount(v);
+#elif defined(_MSC_VER)
+  return __popcnt(v);
+#else
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+  return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+}
+
+inline std::size_t count_trailing_zeros(boost::uint32_t v) {
+  BOOST_ASSERT(v != 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(v);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, v);
+  return index;
+#else
+  std::size_t n = 0;
+  while(!(v & 1)) {
+    v >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_SIMD_HPP
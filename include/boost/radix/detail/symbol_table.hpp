@@ -0,0 +1,213 @@
+//
+// boost/radix/detail/symbol_table.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_SYMBOLTABLE_HPP
+#define BOOST_RADIX_DETAIL_SYMBOLTABLE_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/detail/binary_text.hpp>
+#include <boost/radix/detail/char_classifier.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix { namespace detail {
+
+#if BOOST_RADIX_SIMD_SSSE3
+// pshufb controls that gather the kept bytes of an 8 byte group to the front,
+// indexed by the mask of bytes to keep.
+struct compress_table {
+  compress_table() {
+    for(int keep = 0; keep < 256; ++keep) {
+      int n = 0;
+      for(int i = 0; i < 8; ++i) {
+        if(keep & (1 << i))
+          indices[keep][n++] = static_cast<unsigned char>(i);
+      }
+      for(; n < 8; ++n)
+        indices[keep][n] = 0x80;
+    }
+  }
+
+  unsigned char indices[256][8];
+};
+
+inline compress_table const& get_compress_table() {
+  static compress_table const table;
+  return table;
+}
+#endif
+
+// Copies the characters of a 32 character block whose bit in drop is clear
+// to out, preserving order, and returns how many were copied. out needs room
+// for the full 32 characters.
+inline std::size_t
+compress_block(char_type const* block, boost::uint32_t drop, char_type* out) {
+  std::size_t n = 0;
+#if BOOST_RADIX_SIMD_SSSE3
+  compress_table const& table = get_compress_table();
+  for(int group = 0; group < 4; ++group) {
+    unsigned keep = ~(drop >> (group * 8)) & 0xFF;
+    __m128i chars =
+        _mm_loadl_epi64(reinterpret_cast<__m128i const*>(block + group * 8));
+    __m128i control =
+        _mm_loadl_epi64(reinterpret_cast<__m128i const*>(table.indices[keep]));
+    _mm_storel_epi64(
+        reinterpret_cast<__m128i*>(out + n), _mm_shuffle_epi8(chars, control));
+    n += popcount(keep);
+  }
+#else
+  for(std::size_t i = 0; i < 32; ++i) {
+    out[n] = block[i];
+    n += ((drop >> i) & 1) ^ 1;
+  }
+#endif
+  return n;
+}
+
+// The characters validate_character consumes as symbols, excluding the pad
+// character.
+template <typename Codec>
+char_set make_symbol_char_set(
+    Codec const& codec, char_classifier<Codec> const& classifier) {
+  boost::array<bool, 256> members;
+  for(int i = 0; i < 256; ++i) {
+    char_type c = static_cast<char_type>(i);
+    members[i]  = classifier.classify(c) == char_class_alphabet &&
+                 codec.bits_from_char(c) != codec.get_pad_bits();
+  }
+  return char_set(members);
+}
+
+// The characters validate_character consumes, including the pad character.
+template <typename Codec>
+char_set make_alphabet_char_set(char_classifier<Codec> const& classifier) {
+  boost::array<bool, 256> members;
+  for(int i = 0; i < 256; ++i)
+    members[i] = classifier.classify(static_cast<char_type>(i)) ==
+                 char_class_alphabet;
+  return char_set(members);
+}
+
+// Number of bytes the decoder writes for symbol_count consumed symbols, the
+// first pad being at first_pad, or symbol_count if there is none. Every
+// segment but the last is written in full and the last is resolved up to the
+// first pad within it.
+template <typename Codec>
+std::size_t
+decoded_size_of_symbols(std::size_t symbol_count, std::size_t first_pad) {
+  std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+  std::size_t const unpacked =
+      codec_traits::unpacked_segment_size<Codec>::value;
+  std::size_t const bits = codec_traits::required_bits<Codec>::value;
+  if(!symbol_count)
+    return 0;
+
+  std::size_t const full_segments = (symbol_count - 1) / unpacked;
+  std::size_t const last_start    = full_segments * unpacked;
+  std::size_t const last_symbols =
+      first_pad > last_start ? first_pad - last_start : 0;
+  return full_segments * packed + (bits > 1 ? last_symbols * bits / 8 : 1);
+}
+
+// -----------------------------------------------------------------------------
+// Maps characters straight to symbols a block at a time for the decoder's
+// fast path. Anything that validate_character would not simply consume,
+// including the pad character, maps to a value with the top bit set so a
+// whole block can be checked with a single test after the lookups. Whitespace
+// is found with the char_classifier and compacted out of the block before the
+// lookups when the error handler would skip it anyway. 1 bit codecs can skip
+// the symbols and go straight to bytes.
+template <typename Codec>
+class symbol_table {
+ public:
+  BOOST_STATIC_CONSTANT(std::size_t, block_size = 32);
+
+  explicit symbol_table(Codec const& codec)
+      : classifier_(codec)
+#if BOOST_RADIX_SIMD_SSSE3
+      , binary_(codec.char_from_bits(0), codec.char_from_bits(1))
+#endif
+  {
+    for(int i = 0; i < 256; ++i) {
+      char_type c = static_cast<char_type>(i);
+      if(classifier_.classify(c) == char_class_alphabet &&
+         c != codec.get_pad_char())
+        symbols_[i] = codec.bits_from_char(c);
+      else
+        symbols_[i] = not_a_symbol;
+    }
+  }
+
+  // Writes the symbols for the block_size characters at block to out and
+  // sets count to the number written. Returns false, with out in an
+  // unspecified state, if the block contains anything that needs to go
+  // through validate_character one character at a time.
+  bool to_symbols(
+      char_type const* block,
+      bits_type* out,
+      std::size_t& count,
+      bool skip_whitespace) const {
+    char_type compacted[block_size];
+    char_type const* chars = block;
+    count                  = block_size;
+    if(boost::uint32_t whitespace = classifier_.whitespace_mask(block)) {
+      if(!skip_whitespace)
+        return false;
+      count = compress_block(block, whitespace, compacted);
+      chars = compacted;
+    }
+
+    bits_type invalid = 0;
+    for(std::size_t i = 0; i < count; ++i) {
+      bits_type symbol = symbols_[static_cast<unsigned char>(chars[i])];
+      out[i]           = symbol;
+      invalid |= symbol;
+    }
+
+    return (invalid & not_a_symbol) == 0;
+  }
+
+  // Writes the block_size / 8 bytes for a block holding nothing but the
+  // characters for 0 and 1 of a 1 bit codec, most significant bit first.
+  // Returns false, writing nothing, for any other block or codec.
+#if BOOST_RADIX_SIMD_SSSE3
+  bool to_bytes(char_type const* block, bits_type* out) const {
+    BOOST_STATIC_ASSERT(block_size == binary_text::block_size);
+    return codec_traits::required_bits<Codec>::value == 1 &&
+           binary_.to_bytes(block, out);
+  }
+#else
+  bool to_bytes(char_type const*, bits_type*) const {
+    return false;
+  }
+#endif
+
+ private:
+  BOOST_STATIC_CONSTANT(bits_type, not_a_symbol = 0x80);
+
+  char_classifier<Codec> classifier_;
+  boost::array<bits_type, 256> symbols_;
+#if BOOST_RADIX_SIMD_SSSE3
+  binary_text binary_;
+#endif
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_DETAIL_SYMBOLTABLE_HPP
@@ -0,0 +1,175 @@
+//
+// boost/radix/detail/vector_bitstream.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_DETAIL_VECTORBITSTREAM_HPP
+#define BOOST_RADIX_DETAIL_VECTORBITSTREAM_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/bit_order.hpp>
+#include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/simd.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/integer/common_factor.hpp>
+#include <boost/static_assert.hpp>
+
+#include <cstring>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+#if BOOST_RADIX_SIMD_VECTOR_EXTENSIONS
+
+namespace boost { namespace radix { namespace detail {
+
+typedef boost::uint8_t vector_u8x16 __attribute__((vector_size(16)));
+typedef boost::uint16_t vector_u16x16 __attribute__((vector_size(32)));
+
+// Shuffle index that selects zero.
+boost::uint8_t const vector_zero_lane = 0x90;
+
+inline vector_u8x16 shuffle_bytes(vector_u8x16 v, vector_u8x16 indices) {
+#  if defined(__clang__)
+  return (vector_u8x16)_mm_shuffle_epi8((__m128i)v, (__m128i)indices);
+#  else
+  vector_u8x16 const zero = {0};
+  return __builtin_shuffle(v, zero, indices);
+#  endif
+}
+
+// -----------------------------------------------------------------------------
+// Packs and unpacks segments of any width up to 8 bits in either bit order,
+// 16 symbols at a time. Every symbol lies within two adjacent bytes, so
+// unpacking gathers those bytes into a 16 bit lane, multiplies to bring the
+// symbol to the top and shifts it down. MSB first puts the first of the two
+// bytes in the top of the lane and LSB first puts it in the bottom. Packing
+// works the other way round, one round per symbol that can share a byte. The
+// shuffles and multipliers come from the segment sizes rather than being
+// written out for each width and order.
+template <std::size_t Bits, bit_order Order>
+class vector_bitstream {
+ public:
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      packed_segment_size = bits::to_packed_segment_size<Bits>::value);
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      unpacked_segment_size = bits::to_unpacked_segment_size<Bits>::value);
+  BOOST_STATIC_CONSTANT(std::size_t, block_symbols = 16);
+  BOOST_STATIC_CONSTANT(
+      std::size_t, block_segments = block_symbols / unpacked_segment_size);
+  BOOST_STATIC_CONSTANT(
+      std::size_t, block_bytes = block_segments * packed_segment_size);
+
+  // The most symbols that share a byte. A byte starting o bits into a
+  // symbol overlaps ceil((o + 8) / Bits) of them, and o is at most Bits less
+  // the alignment segments share with bytes.
+  BOOST_STATIC_CONSTANT(
+      std::size_t,
+      pack_rounds =
+          (2 * Bits - boost::integer::static_gcd<Bits, 8>::value + 7) / Bits);
+
+  // Widths that divide a byte pack without carries, which compilers already
+  // vectorise well, and beyond three rounds the scalar code is as quick.
+  BOOST_STATIC_CONSTANT(
+      bool, fast_pack = 8 % Bits != 0 && pack_rounds <= 3);
+
+  BOOST_STATIC_ASSERT(Bits <= 8);
+  BOOST_STATIC_ASSERT(block_symbols % unpacked_segment_size == 0);
+
+  static vector_bitstream const& instance() {
+    static vector_bitstream const stream;
+    return stream;
+  }
+
+  // Reads 16 bytes from packed, of which block_bytes are used.
+  void unpack(bits_type const* packed, bits_type* symbols) const {
+    vector_u8x16 bytes;
+    std::memcpy(&bytes, packed, sizeof(bytes));
+    vector_u16x16 pairs =
+        (__builtin_convertvector(shuffle_bytes(bytes, high_), vector_u16x16)
+         << 8) |
+        __builtin_convertvector(shuffle_bytes(bytes, low_), vector_u16x16);
+    vector_u16x16 values = (pairs * unpack_scale_) >> (16 - Bits);
+    vector_u8x16 result  = __builtin_convertvector(values, vector_u8x16);
+    std::memcpy(symbols, &result, sizeof(result));
+  }
+
+  void pack(bits_type const* symbols, bits_type* packed) const {
+    vector_u8x16 values;
+    std::memcpy(&values, symbols, sizeof(values));
+    vector_u16x16 bytes = {0};
+    for(std::size_t r = 0; r < pack_rounds; ++r) {
+      vector_u16x16 part = __builtin_convertvector(
+          shuffle_bytes(values, pack_sources_[r]), vector_u16x16);
+      bytes |= (part * pack_scales_[r]) >> 8;
+    }
+    vector_u8x16 result = __builtin_convertvector(bytes, vector_u8x16);
+    std::memcpy(packed, &result, block_bytes);
+  }
+
+ private:
+  vector_bitstream() {
+    for(std::size_t k = 0; k < block_symbols; ++k) {
+      std::size_t const bit    = k * Bits;
+      std::size_t const offset = bit % 8;
+      boost::uint8_t const first = boost::uint8_t(bit / 8);
+      boost::uint8_t const second =
+          offset + Bits > 8 ? boost::uint8_t(bit / 8 + 1) : vector_zero_lane;
+      if(Order == bit_order_msb_first) {
+        high_[k]         = first;
+        low_[k]          = second;
+        unpack_scale_[k] = boost::uint16_t(1u << offset);
+      } else {
+        high_[k]         = second;
+        low_[k]          = first;
+        unpack_scale_[k] = boost::uint16_t(1u << (16 - Bits - offset));
+      }
+    }
+
+    // Output byte j takes the part of each symbol k that overlaps it. Moving
+    // the symbol so that the part lands in the top byte of the lane, and
+    // letting anything above that fall off, leaves just that part.
+    for(std::size_t r = 0; r < pack_rounds; ++r) {
+      for(std::size_t j = 0; j < block_symbols; ++j) {
+        pack_sources_[r][j] = vector_zero_lane;
+        pack_scales_[r][j]  = 0;
+      }
+    }
+    for(std::size_t j = 0; j < block_bytes; ++j) {
+      std::size_t r = 0;
+      for(std::size_t k = 0; k < block_symbols; ++k) {
+        if(k * Bits >= 8 * j + 8 || k * Bits + Bits <= 8 * j)
+          continue;
+        std::size_t const e = Order == bit_order_msb_first
+                                  ? 16 + 8 * j - k * Bits - Bits
+                                  : 8 + k * Bits - 8 * j;
+        pack_sources_[r][j] = boost::uint8_t(k);
+        pack_scales_[r][j]  = boost::uint16_t(1u << e);
+        ++r;
+      }
+      BOOST_ASSERT(r <= pack_rounds);
+    }
+  }
+
+  vector_u8x16 high_;
+  vector_u8x16 low_;
+  vector_u16x16 unpack_scale_;
+  vector_u8x16 pack_sources_[pack_rounds];
+  vector_u16x16 pack_scales_[pack_rounds];
+};
+
+}}} // namespace boost::radix::detail
+
+#endif // BOOST_RADIX_SIMD_VECTOR_EXTENSIONS
+
+#endif // BOOST_RADIX_DETAIL_VECTORBITSTREAM_HPP
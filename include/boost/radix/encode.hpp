@@ -12,14 +12,23 @@
 
 #include <boost/radix/common.hpp>
 
+#include <boost/radix/codec_traits/bit_order.hpp>
 #include <boost/radix/codec_traits/pad.hpp>
 #include <boost/radix/codec_traits/segment.hpp>
 #include <boost/radix/codec_traits/whitespace.hpp>
+#include <boost/radix/detail/binary_text.hpp>
+#include <boost/radix/line_wrapping.hpp>
+#include <boost/radix/static_ibitstream_lsb.hpp>
 #include <boost/radix/static_ibitstream_msb.hpp>
 
 #include <boost/array.hpp>
 #include <boost/move/utility.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
 
+#include <iterator>
 #include <memory>
 #include <utility>
 
@@ -31,6 +40,117 @@
 //
 namespace boost { namespace radix {
 
+namespace detail {
+
+template <typename Codec>
+std::size_t unwrapped_encoded_size(std::size_t source_size) {
+  return codec_traits::unpacked_segment_size<Codec>::value *
+         ((source_size + (codec_traits::packed_segment_size<Codec>::value - 1)) /
+          codec_traits::packed_segment_size<Codec>::value);
+}
+
+// Input is passed to an accumulator this many bytes at a time, straight
+// after it has been encoded and while it is still in cache.
+std::size_t const accumulate_chunk_size = 4096;
+
+template <typename Accumulator, typename T>
+void accumulate(Accumulator& acc, T const* first, T const* last) {
+  BOOST_STATIC_ASSERT(sizeof(T) == 1);
+  acc.process_bytes(first, last - first);
+}
+
+template <typename Accumulator, typename T>
+void accumulate(Accumulator& acc, T* first, T* last) {
+  accumulate(acc, static_cast<T const*>(first), static_cast<T const*>(last));
+}
+
+// Other iterators are copied a buffer at a time so the accumulator still
+// sees blocks rather than single bytes.
+template <typename Accumulator, typename Iterator>
+void accumulate(Accumulator& acc, Iterator first, Iterator last) {
+  boost::array<bits_type, 256> buffer;
+  while(first != last) {
+    std::size_t count = 0;
+    for(; count < buffer.size() && first != last; ++first)
+      buffer[count++] = *first;
+    acc.process_bytes(buffer.data(), count);
+  }
+}
+
+// The unpacker for the codec's bit order.
+template <
+    typename Codec,
+    bit_order Order = codec_traits::segment_bit_order<Codec>::value>
+struct default_segment_unpacker {
+  typedef static_ibitstream_msb<codec_traits::required_bits<Codec>::value>
+      type;
+};
+
+template <typename Codec>
+struct default_segment_unpacker<Codec, bit_order_lsb_first> {
+  typedef static_ibitstream_lsb<codec_traits::required_bits<Codec>::value>
+      type;
+};
+
+// Writes the characters for count segments straight from the input, or
+// returns false to have them unpacked to symbols and mapped one at a time.
+// Only 1 bit codecs unpacked MSB first from contiguous input have a way to
+// do that.
+template <typename SegmentUnpacker, typename Iterator, typename Codec>
+bool segments_to_chars(
+    SegmentUnpacker const&, Iterator, std::size_t, Codec const&, char_type*) {
+  return false;
+}
+
+#if BOOST_RADIX_SIMD_SSSE3
+template <typename Codec>
+bool segments_to_chars(
+    static_ibitstream_msb<1> const&,
+    bits_type const* first,
+    std::size_t count,
+    Codec const& codec,
+    char_type* out) {
+  binary_text(codec.char_from_bits(0), codec.char_from_bits(1))
+      .to_chars(first, count, out);
+  return true;
+}
+
+template <typename Codec>
+bool segments_to_chars(
+    static_ibitstream_msb<1> const& unpacker,
+    bits_type* first,
+    std::size_t count,
+    Codec const& codec,
+    char_type* out) {
+  return segments_to_chars(
+      unpacker, static_cast<bits_type const*>(first), count, codec, out);
+}
+
+template <typename Codec>
+bool segments_to_chars(
+    static_ibitstream_msb<1> const& unpacker,
+    char_type const* first,
+    std::size_t count,
+    Codec const& codec,
+    char_type* out) {
+  return segments_to_chars(
+      unpacker, reinterpret_cast<bits_type const*>(first), count, codec, out);
+}
+
+template <typename Codec>
+bool segments_to_chars(
+    static_ibitstream_msb<1> const& unpacker,
+    char_type* first,
+    std::size_t count,
+    Codec const& codec,
+    char_type* out) {
+  return segments_to_chars(
+      unpacker, reinterpret_cast<bits_type const*>(first), count, codec, out);
+}
+#endif
+
+} // namespace detail
+
 // -----------------------------------------------------------------------------
 //
 namespace adl {
@@ -38,16 +158,17 @@ namespace adl {
 template <typename Codec>
 std::size_t get_encoded_size(std::size_t source_size, Codec const& codec) {
   // By default, size is an integer multiple of the output
-  // segment size.
-  return codec_traits::unpacked_segment_size<Codec>::value *
-         (source_size + (codec_traits::packed_segment_size<Codec>::value - 1) /
-                            codec_traits::packed_segment_size<Codec>::value);
+  // segment size, plus a terminator between each full line.
+  std::size_t const encoded_size =
+      detail::unwrapped_encoded_size<Codec>(source_size);
+  using boost::radix::adl::get_line_wrapping;
+  return encoded_size + get_line_wrapping(codec).wrapped_overhead(encoded_size);
 }
 
 template <typename Codec>
-static_ibitstream_msb<codec_traits::required_bits<Codec>::value>
-get_segment_unpacker(Codec const& codec) {
-  return static_ibitstream_msb<codec_traits::required_bits<Codec>::value>();
+typename detail::default_segment_unpacker<Codec>::type
+get_segment_unpacker(Codec const&) {
+  return typename detail::default_segment_unpacker<Codec>::type();
 }
 
 } // namespace adl
@@ -63,7 +184,18 @@ class encoder {
   encoder(Codec const& codec, OutputIterator out)
       : codec_(codec)
       , out_(out)
-      , bytes_written_(0) {
+      , bytes_written_(0)
+      , line_position_(0)
+      , wrapping_(default_line_wrapping(codec)) {
+  }
+
+  // Overrides the line wrapping the codec asks for.
+  encoder(Codec const& codec, OutputIterator out, line_wrapping wrapping)
+      : codec_(codec)
+      , out_(out)
+      , bytes_written_(0)
+      , line_position_(0)
+      , wrapping_(wrapping) {
   }
 
   ~encoder() {
@@ -79,10 +211,37 @@ class encoder {
     return bytes_appended;
   }
 
+  // Appends as above, and also passes the bytes to acc, which needs a
+  // process_bytes(void const*, std::size_t) member as boost::crc_optimal
+  // has. The input is taken a few KiB at a time and given to acc as soon as
+  // it has been encoded, so it is only read from memory once.
+  template <typename Iterator, typename EndIterator, typename Accumulator>
+  std::size_t append(Iterator first, EndIterator last, Accumulator& acc) {
+    return append_accumulate(
+        first, last, acc,
+        typename std::iterator_traits<Iterator>::iterator_category());
+  }
+
+  // Appends each buffer of a buffer sequence in turn. Only the bytes that
+  // straddle a buffer boundary are copied into the partial segment, the rest
+  // are encoded directly from the source buffers.
+  template <typename ConstBufferSequence>
+  std::size_t append_buffers(ConstBufferSequence const& buffers) {
+    typedef typename boost::range_iterator<ConstBufferSequence const>::type
+        buffer_iterator;
+    std::size_t bytes_appended = 0;
+    for(buffer_iterator i = boost::begin(buffers), e = boost::end(buffers);
+        i != e; ++i) {
+      bytes_appended += append(boost::begin(*i), boost::end(*i));
+    }
+    return bytes_appended;
+  }
+
   std::size_t append(bits_type bits) {
     packed_segment_.push_back(bits);
     if(packed_segment_.full()) {
       using boost::radix::adl::get_segment_unpacker;
+      bytes_written_ += terminator_bytes_before(UnpackedSegmentSize);
       unpack_segment(packed_segment_.begin(), get_segment_unpacker(codec_));
       bytes_written_ += UnpackedSegmentSize;
       packed_segment_.clear();
@@ -106,22 +265,35 @@ class encoder {
         maybe_pad_segment(packed_segment_.size(), unpacked_segment);
     packed_segment_.clear();
 
-    out_ = std::transform(
-        unpacked_segment.begin(), unpacked_segment.begin() + unpacked_size,
-        out_, bits_to_char_mapper(codec_));
+    std::size_t terminator_bytes = terminator_bytes_before(unpacked_size);
+    format_segment(
+        unpacked_segment.begin(), unpacked_segment.begin() + unpacked_size);
 
-    bytes_written_ += unpacked_size;
+    bytes_written_ += unpacked_size + terminator_bytes;
 
-    return unpacked_size;
+    return unpacked_size + terminator_bytes;
   }
 
   void abort() {
     packed_segment_.clear();
   }
 
+  // Carries on from earlier output instead of starting afresh:
+  // line_position characters are already on the current line and
+  // [first, last) are the bytes appended since the last whole segment was
+  // written, which must be fewer than a segment.
+  template <typename Iterator, typename EndIterator>
+  void resume(Iterator first, EndIterator last, std::size_t line_position) {
+    abort();
+    fill_packed_segment(first, last, packed_segment_);
+    BOOST_ASSERT(first == last && !packed_segment_.full());
+    line_position_ = line_position;
+  }
+
   void reset(OutputIterator out) {
     abort();
     bytes_written_ = 0;
+    line_position_ = 0;
     out_           = boost::move(out);
   }
 
@@ -129,7 +301,57 @@ class encoder {
     return bytes_written_;
   }
 
+  line_wrapping const& wrapping() const {
+    return wrapping_;
+  }
+
+  Codec const& codec() const {
+    return codec_;
+  }
+
  private:
+  static line_wrapping default_line_wrapping(Codec const& codec) {
+    using boost::radix::adl::get_line_wrapping;
+    return get_line_wrapping(codec);
+  }
+
+  template <typename Iterator, typename Accumulator>
+  std::size_t append_accumulate(
+      Iterator first,
+      Iterator last,
+      Accumulator& acc,
+      std::random_access_iterator_tag) {
+    std::size_t const chunk =
+        detail::accumulate_chunk_size / PackedSegmentSize * PackedSegmentSize;
+    std::size_t bytes_appended = 0;
+    while(first != last) {
+      Iterator chunk_last =
+          first + std::min<std::size_t>(std::distance(first, last), chunk);
+      bytes_appended += append(first, chunk_last);
+      detail::accumulate(acc, first, chunk_last);
+      first = chunk_last;
+    }
+    return bytes_appended;
+  }
+
+  // Single pass iterators can't be read twice, so each chunk is copied out
+  // first.
+  template <typename Iterator, typename EndIterator, typename Accumulator>
+  std::size_t append_accumulate(
+      Iterator first, EndIterator last, Accumulator& acc, ...) {
+    boost::array<bits_type, detail::accumulate_chunk_size> chunk;
+    std::size_t bytes_appended = 0;
+    while(first != last) {
+      std::size_t count = 0;
+      for(; count < chunk.size() && first != last; ++first)
+        chunk[count++] = *first;
+      bits_type const* data = chunk.data();
+      bytes_appended += append(data, data + count);
+      acc.process_bytes(data, count);
+    }
+    return bytes_appended;
+  }
+
   //
   template <typename Iterator, typename EndIterator, typename SegmentUnpacker>
   std::size_t append_impl(
@@ -140,6 +362,7 @@ class encoder {
         return 0;
       }
       BOOST_ASSERT(packed_segment_.full());
+      bytes_appended += terminator_bytes_before(UnpackedSegmentSize);
       unpack_segment(packed_segment_.begin(), segment_unpacker);
       packed_segment_.clear();
       bytes_appended += codec_traits::unpacked_segment_size<Codec>::value;
@@ -161,10 +384,18 @@ class encoder {
     std::size_t full_segment_count =
         std::distance(first, last) / PackedSegmentSize;
     bytes_appended += full_segment_count * UnpackedSegmentSize;
-
-    while(full_segment_count--) {
-      unpack_segment(first, segment_unpacker);
-      first += PackedSegmentSize;
+    bytes_appended +=
+        terminator_bytes_before(full_segment_count * UnpackedSegmentSize);
+
+    if(!wrapping_.enabled() ||
+       (wrapping_.line_length() % UnpackedSegmentSize == 0 &&
+        line_position_ % UnpackedSegmentSize == 0)) {
+      first = write_segments(first, full_segment_count, segment_unpacker);
+    } else {
+      while(full_segment_count--) {
+        unpack_segment(first, segment_unpacker);
+        first += PackedSegmentSize;
+      }
     }
 
     fill_packed_segment(first, last, packed_segment_);
@@ -182,6 +413,7 @@ class encoder {
       if(!fill_packed_segment(first, last, packed_segment_))
         break;
       BOOST_ASSERT(packed_segment_.full());
+      bytes_appended += terminator_bytes_before(UnpackedSegmentSize);
       unpack_segment(packed_segment_.begin(), segment_unpacker);
       packed_segment_.clear();
       bytes_appended += UnpackedSegmentSize;
@@ -193,15 +425,68 @@ class encoder {
   template <typename Iterator, typename EndIterator, typename PackedSegment>
   bool fill_packed_segment(
       Iterator& first, EndIterator last, PackedSegment& packed) {
-    typename PackedSegment::iterator pbegin = packed.end();
-    typename PackedSegment::iterator pend = packed.begin() + packed.capacity();
+    // Indexed against the capacity so the bound is plain to the optimiser,
+    // which otherwise can't see that size() never exceeds it.
+    std::size_t size = packed.size();
+    while(first != last && size < packed.capacity()) {
+      packed[size++] = *first++;
+    }
+
+    packed.resize(size);
+    return size == packed.capacity();
+  }
+
+  // Encodes runs of whole segments, a line at a time when wrapping, so the
+  // wrapping is handled once per line instead of once per segment. This
+  // requires segments to pack evenly into a line. The output iterator is
+  // kept in a local because writes through it may otherwise alias members.
+  template <typename RandomAccessInputIterator, typename SegmentUnpacker>
+  RandomAccessInputIterator write_segments(
+      RandomAccessInputIterator first,
+      std::size_t segment_count,
+      SegmentUnpacker& segment_unpacker) {
+    // Unwrapped output is treated as one line that never ends.
+    bool const wrap = wrapping_.enabled();
+    std::size_t const line_length =
+        wrap ? wrapping_.line_length() : segment_count * UnpackedSegmentSize;
+    std::size_t line_position = wrap ? line_position_ : 0;
+    OutputIterator out        = out_;
+    bits_to_char_mapper mapper(codec_);
+    while(segment_count) {
+      if(line_position == line_length) {
+        out           = wrapping_.write_terminator(out);
+        line_position = 0;
+      }
 
-    while(first != last && pbegin != pend) {
-      *pbegin++ = *first++;
+      std::size_t line_segments = std::min(
+          segment_count, (line_length - line_position) / UnpackedSegmentSize);
+      segment_count -= line_segments;
+      line_position += line_segments * UnpackedSegmentSize;
+      while(line_segments) {
+        std::size_t const count = std::min(
+            line_segments, unpack_buffer_size / UnpackedSegmentSize);
+        boost::array<char_type, unpack_buffer_size> chars;
+        if(detail::segments_to_chars(
+               segment_unpacker, first, count, codec_, chars.data())) {
+          out = std::copy(
+              chars.begin(), chars.begin() + count * UnpackedSegmentSize, out);
+        } else {
+          boost::array<bits_type, unpack_buffer_size> buffer;
+          detail::unpack_segments<PackedSegmentSize, UnpackedSegmentSize>(
+              segment_unpacker, first, count, buffer.data());
+          out = std::transform(
+              buffer.begin(), buffer.begin() + count * UnpackedSegmentSize,
+              out, mapper);
+        }
+        first += count * PackedSegmentSize;
+        line_segments -= count;
+      }
     }
 
-    packed.resize(std::distance(packed.begin(), pbegin));
-    return pbegin == pend;
+    if(wrap)
+      line_position_ = line_position;
+    out_ = out;
+    return first;
   }
 
   template <typename RandomAccessInputIterator, typename SegmentUnpacker>
@@ -228,67 +513,41 @@ class encoder {
   };
 
   template <typename InputIterator>
-  void format_segment(InputIterator first, InputIterator last) {
-    out_ = std::transform(
-        first, last,
-        maybe_add_line_break_iterator(
-            typename codec_traits::requires_line_breaks<Codec>::type()),
-        bits_to_char_mapper(codec_));
+  void write_chars(InputIterator first, InputIterator last) {
+    out_ = std::transform(first, last, out_, bits_to_char_mapper(codec_));
   }
 
-  template <typename InnerIterator, std::size_t MaxLineLength>
-  class line_break_iterator
-      : public std::iterator<std::output_iterator_tag, void, void, void, void> {
-   public:
-    line_break_iterator(InnerIterator iter, std::size_t current_char)
-        : iter_(iter)
-        , char_(current_char) {
-    }
-
-    line_break_iterator& operator++() {
-      return *this;
-    }
-
-    line_break_iterator& operator++(int) {
-      return *this;
-    }
-
-    line_break_iterator& operator*() {
-      return *this;
+  // Writes a terminator before any character that would otherwise overflow
+  // the current line, so the output never ends with a terminator.
+  template <typename InputIterator>
+  void format_segment(InputIterator first, InputIterator last) {
+    if(!wrapping_.enabled()) {
+      write_chars(first, last);
+      return;
     }
 
-    template <typename T>
-    line_break_iterator& operator=(T const& t) {
-      ++char_;
-      if(char_ == MaxLineLength) {
-        *iter_++ = '\n';
-        char_    = 0;
+    std::size_t const line_length = wrapping_.line_length();
+    while(first != last) {
+      if(line_position_ == line_length) {
+        out_           = wrapping_.write_terminator(out_);
+        line_position_ = 0;
       }
 
-      *iter_++ = t;
-      return *this;
+      std::size_t count = std::min<std::size_t>(
+          line_length - line_position_, std::distance(first, last));
+      write_chars(first, first + count);
+      first += count;
+      line_position_ += count;
     }
-
-    operator InnerIterator() {
-      return iter_;
-    }
-
-   private:
-    InnerIterator iter_;
-    std::size_t char_;
-  };
-
-  line_break_iterator<
-      OutputIterator,
-      codec_traits::max_encoded_line_length<Codec>::value>
-  maybe_add_line_break_iterator(boost::true_type) {
-    return line_break_iterator<
-        OutputIterator, codec_traits::max_encoded_line_length<Codec>::value>(
-        out_);
   }
 
-  OutputIterator maybe_add_line_break_iterator(boost::false_type) {
-    return out_;
+  // Number of terminator chars that will be emitted while writing the next
+  // char_count characters.
+  std::size_t terminator_bytes_before(std::size_t char_count) const {
+    if(!wrapping_.enabled() || !char_count)
+      return 0;
+    return (line_position_ + char_count - 1) / wrapping_.line_length() *
+           wrapping_.terminator_size();
   }
 
   std::size_t get_unpacked_size_from_packed_size(std::size_t packed_size) {
@@ -304,6 +563,10 @@ class encoder {
   static const std::size_t UnpackedSegmentSize =
       codec_traits::unpacked_segment_size<Codec>::value;
 
+  // Symbols unpacked at a time before being mapped to characters.
+  static const std::size_t unpack_buffer_size =
+      UnpackedSegmentSize > 256 ? UnpackedSegmentSize : 256;
+
   std::size_t maybe_pad_segment_impl(
       std::size_t packed_size,
       boost::array<char_type, UnpackedSegmentSize>& unpacked,
@@ -334,6 +597,8 @@ class encoder {
   Codec const& codec_;
   OutputIterator out_;
   std::size_t bytes_written_;
+  std::size_t line_position_;
+  line_wrapping wrapping_;
 
   typedef detail::segment_buffer<bits_type, PackedSegmentSize>
       packed_segment_type;
@@ -346,6 +611,12 @@ encoder<Codec, OutputIterator> make_encoder(
   return encoder<Codec, OutputIterator>(codec, out);
 }
 
+template <typename Codec, typename OutputIterator>
+encoder<Codec, OutputIterator> make_encoder(
+    Codec const& codec, OutputIterator out, line_wrapping wrapping) {
+  return encoder<Codec, OutputIterator>(codec, out, wrapping);
+}
+
 // -----------------------------------------------------------------------------
 //
 template <typename Codec>
@@ -354,6 +625,18 @@ std::size_t encoded_size(std::size_t source_size, Codec const& codec) {
   return get_encoded_size(source_size, codec);
 }
 
+// As above, but with the codec's own line wrapping, if it has any, replaced
+// by wrapping.
+template <typename Codec>
+std::size_t encoded_size(
+    std::size_t source_size, Codec const& codec, line_wrapping wrapping) {
+  using boost::radix::adl::get_encoded_size;
+  using boost::radix::adl::get_line_wrapping;
+  std::size_t const encoded_size = get_line_wrapping(codec).unwrapped_size(
+      get_encoded_size(source_size, codec));
+  return encoded_size + wrapping.wrapped_overhead(encoded_size);
+}
+
 // -----------------------------------------------------------------------------
 //
 template <
@@ -372,6 +655,76 @@ std::size_t encode(
   return e.bytes_written();
 }
 
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec>
+std::size_t encode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    line_wrapping wrapping) {
+  encoder<Codec, OutputIterator> e(codec, out, wrapping);
+  e.append(first, last);
+  e.resolve();
+  return e.bytes_written();
+}
+
+// Encodes as above, also passing the input to acc while it is in cache, as
+// encoder::append does. For a checksum or hash of the raw bytes alongside
+// the encoding without reading them twice.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec,
+    typename Accumulator>
+std::size_t encode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    Accumulator& acc) {
+  encoder<Codec, OutputIterator> e(codec, out);
+  e.append(first, last, acc);
+  e.resolve();
+  return e.bytes_written();
+}
+
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec,
+    typename Accumulator>
+std::size_t encode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    line_wrapping wrapping,
+    Accumulator& acc) {
+  encoder<Codec, OutputIterator> e(codec, out, wrapping);
+  e.append(first, last, acc);
+  e.resolve();
+  return e.bytes_written();
+}
+
+// -----------------------------------------------------------------------------
+//
+template <typename ConstBufferSequence, typename OutputIterator, typename Codec>
+std::size_t encode_buffers(
+    ConstBufferSequence const& buffers,
+    OutputIterator out,
+    Codec const& codec) {
+  encoder<Codec, OutputIterator> e(codec, out);
+  e.append_buffers(buffers);
+  e.resolve();
+  return e.bytes_written();
+}
+
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_ENCODE_HPP
@@ -52,6 +52,23 @@ class invalid_whitespace
   char char_;
 };
 
+// A symbol following the padding, which can only come at the end.
+class invalid_padding
+    : public std::exception
+    , public boost::exception {
+ public:
+  invalid_padding(char_type which)
+      : char_(which) {
+  }
+
+  char value() {
+    return char_;
+  }
+
+ private:
+  char char_;
+};
+
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_EXCEPTION_HPP
@@ -0,0 +1,375 @@
+//
+// boost/radix/find_encoded.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_FINDENCODED_HPP
+#define BOOST_RADIX_FINDENCODED_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/simd.hpp>
+#include <boost/radix/encode.hpp>
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+namespace detail {
+
+// Segments are searched this many at a time for every byte offset of the
+// pattern, so the earliest match is found without a pass per offset.
+std::size_t const find_encoded_chunk_segments = 4096;
+
+// -----------------------------------------------------------------------------
+// The characters the encoding of a byte pattern has to consist of when the
+// pattern starts byte_offset bytes into a segment. Symbols made only of
+// pattern bits must be one character, while those at the edges that share
+// bits with the surrounding data may be any character agreeing on the
+// pattern's bits. Which bits land in which symbol is found by running the
+// codec's own unpacker, so any packing order works.
+class encoded_pattern {
+ public:
+  template <typename Codec>
+  encoded_pattern(
+      std::vector<bits_type> const& needle,
+      std::size_t byte_offset,
+      Codec const& codec)
+      : byte_offset_(byte_offset)
+      , core_offset_(0)
+      , core_size_(0) {
+    std::size_t const packed =
+        codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    std::size_t const segments =
+        (byte_offset + needle.size() + packed - 1) / packed;
+
+    std::vector<bits_type> bytes(segments * packed, 0);
+    std::copy(needle.begin(), needle.end(), bytes.begin() + byte_offset);
+    std::vector<bits_type> symbols = unpack(bytes, codec);
+
+    // Every bit outside the pattern is flipped in turn to see which symbol
+    // bits it reaches.
+    std::vector<bits_type> unknown(symbols.size(), 0);
+    for(std::size_t i = 0; i < bytes.size(); ++i) {
+      if(i >= byte_offset && i < byte_offset + needle.size())
+        continue;
+      for(int bit = 0; bit < 8; ++bit) {
+        bytes[i] ^= bits_type(1 << bit);
+        std::vector<bits_type> flipped = unpack(bytes, codec);
+        bytes[i] ^= bits_type(1 << bit);
+        for(std::size_t j = 0; j < symbols.size(); ++j)
+          unknown[j] |= bits_type(flipped[j] ^ symbols[j]);
+      }
+    }
+
+    bits_type const all_bits =
+        bits_type((1 << codec_traits::required_bits<Codec>::value) - 1);
+    std::size_t first = 0;
+    std::size_t last  = symbols.size();
+    while(first != last && unknown[first] == all_bits)
+      ++first;
+    while(last != first && unknown[last - 1] == all_bits)
+      --last;
+    symbol_offset_ = first % unpacked;
+
+    std::size_t run = 0;
+    for(std::size_t j = first; j != last; ++j) {
+      boost::array<bool, 256> members;
+      std::size_t count = 0;
+      char_type member  = 0;
+      for(int i = 0; i < 256; ++i) {
+        char_type c = static_cast<char_type>(i);
+        members[i]  = codec.has_char(c) && c != codec.get_pad_char() &&
+                     ((codec.bits_from_char(c) ^ symbols[j]) & ~unknown[j] &
+                      all_bits) == 0;
+        if(members[i]) {
+          member = c;
+          ++count;
+        }
+      }
+
+      if(count == 1) {
+        chars_.push_back(member);
+        sets_.push_back(-1);
+        if(++run > core_size_) {
+          core_size_   = run;
+          core_offset_ = chars_.size() - run;
+        }
+      } else {
+        chars_.push_back(0);
+        sets_.push_back(static_cast<int>(char_sets_.size()));
+        char_sets_.push_back(char_set(members));
+        run = 0;
+      }
+    }
+  }
+
+  // Number of characters in the encoded pattern.
+  std::size_t size() const {
+    return chars_.size();
+  }
+
+  std::size_t byte_offset() const {
+    return byte_offset_;
+  }
+
+  // Position of the first character of the pattern within its segment.
+  std::size_t symbol_offset() const {
+    return symbol_offset_;
+  }
+
+  // The longest run of characters that must match exactly, which the
+  // search looks for first.
+  std::size_t core_offset() const {
+    return core_offset_;
+  }
+
+  std::size_t core_size() const {
+    return core_size_;
+  }
+
+  char_type core_char(std::size_t i) const {
+    return chars_[core_offset_ + i];
+  }
+
+  template <typename RandomAccessIterator>
+  bool matches(RandomAccessIterator at) const {
+    for(std::size_t i = 0; i < chars_.size(); ++i) {
+      char_type c = at[i];
+      if(sets_[i] < 0 ? c != chars_[i] : !char_sets_[sets_[i]].contains(c))
+        return false;
+    }
+    return true;
+  }
+
+ private:
+  template <typename Codec>
+  static std::vector<bits_type>
+  unpack(std::vector<bits_type> const& bytes, Codec const& codec) {
+    std::size_t const packed =
+        codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    std::vector<bits_type> symbols;
+    for(std::size_t i = 0; i < bytes.size(); i += packed) {
+      boost::array<bits_type, codec_traits::unpacked_segment_size<Codec>::value>
+          segment;
+      using boost::radix::adl::get_segment_unpacker;
+      get_segment_unpacker(codec)(bytes.begin() + i, segment);
+      symbols.insert(symbols.end(), segment.begin(), segment.begin() + unpacked);
+    }
+    return symbols;
+  }
+
+  std::size_t byte_offset_;
+  std::size_t symbol_offset_;
+  std::size_t core_offset_;
+  std::size_t core_size_;
+  std::vector<char_type> chars_;
+  std::vector<int> sets_;
+  std::vector<char_set> char_sets_;
+};
+
+// Checks the candidate at text position start, which must begin
+// symbol_offset characters into a segment, and gives the byte offset of the
+// match.
+template <typename RandomAccessIterator>
+boost::optional<std::size_t> match_at(
+    encoded_pattern const& pattern,
+    RandomAccessIterator text,
+    std::size_t text_size,
+    std::size_t start,
+    std::size_t packed,
+    std::size_t unpacked) {
+  if(start < pattern.symbol_offset() || start + pattern.size() > text_size ||
+     (start - pattern.symbol_offset()) % unpacked ||
+     !pattern.matches(text + start))
+    return boost::none;
+  return (start - pattern.symbol_offset()) / unpacked * packed +
+         pattern.byte_offset();
+}
+
+// Finds the first match of pattern starting in one of the segments beginning
+// in [segments_first, segments_last), a character position at a time.
+template <typename RandomAccessIterator>
+boost::optional<std::size_t> find_pattern(
+    encoded_pattern const& pattern,
+    RandomAccessIterator text,
+    std::size_t text_size,
+    std::size_t segments_first,
+    std::size_t segments_last,
+    std::size_t packed,
+    std::size_t unpacked) {
+  for(std::size_t s = segments_first; s < segments_last; s += unpacked) {
+    boost::optional<std::size_t> match = match_at(
+        pattern, text, text_size, s + pattern.symbol_offset(), packed,
+        unpacked);
+    if(match)
+      return match;
+  }
+  return boost::none;
+}
+
+#if BOOST_RADIX_SIMD_SSE2
+inline boost::uint32_t equal_mask(char_type const* block, char_type c) {
+#  if BOOST_RADIX_SIMD_AVX2
+  __m256i chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+  return static_cast<boost::uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c))));
+#  else
+  __m128i const needle = _mm_set1_epi8(c);
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block));
+  __m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16));
+  return static_cast<boost::uint32_t>(
+             _mm_movemask_epi8(_mm_cmpeq_epi8(lo, needle))) |
+         static_cast<boost::uint32_t>(
+             _mm_movemask_epi8(_mm_cmpeq_epi8(hi, needle)))
+             << 16;
+#  endif
+}
+
+// Contiguous text is filtered 32 positions at a time by comparing the first
+// and last characters of the pattern's exact core, and only positions that
+// pass both, at the right place in a segment, are checked in full.
+inline boost::optional<std::size_t> find_pattern(
+    encoded_pattern const& pattern,
+    char_type const* text,
+    std::size_t text_size,
+    std::size_t segments_first,
+    std::size_t segments_last,
+    std::size_t packed,
+    std::size_t unpacked) {
+  if(!pattern.core_size())
+    return find_pattern<char_type const*>(
+        pattern, text, text_size, segments_first, segments_last, packed,
+        unpacked);
+
+  // Positions are those of the first core character. Segments hold a power
+  // of two characters up to 8, so the positions that line up with a segment
+  // fall at the same bits of every block.
+  std::size_t const lead = pattern.symbol_offset() + pattern.core_offset();
+  std::size_t const last_offset = pattern.core_size() - 1;
+  std::size_t position          = segments_first + lead;
+  std::size_t const end         = std::min(
+      segments_last + lead,
+      text_size - std::min(text_size, pattern.size() - pattern.core_offset()) +
+          1);
+  boost::uint32_t aligned = 0;
+  for(std::size_t i = 0; i < 32; i += unpacked)
+    aligned |= boost::uint32_t(1) << i;
+
+  char_type const first_char = pattern.core_char(0);
+  char_type const last_char  = pattern.core_char(last_offset);
+  for(; position + 32 <= end; position += 32) {
+    boost::uint32_t candidates =
+        aligned & equal_mask(text + position, first_char) &
+        equal_mask(text + position + last_offset, last_char);
+    while(candidates) {
+      std::size_t start = position + count_trailing_zeros(candidates) -
+                          pattern.core_offset();
+      boost::optional<std::size_t> match =
+          match_at(pattern, text, text_size, start, packed, unpacked);
+      if(match)
+        return match;
+      candidates &= candidates - 1;
+    }
+  }
+
+  return find_pattern<char_type const*>(
+      pattern, text, text_size, position - lead, segments_last, packed,
+      unpacked);
+}
+#endif
+
+template <typename RandomAccessIterator, typename Codec>
+boost::optional<std::size_t> find_encoded(
+    RandomAccessIterator text,
+    std::size_t text_size,
+    std::vector<bits_type> const& needle,
+    Codec const& codec) {
+  std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+  std::size_t const unpacked =
+      codec_traits::unpacked_segment_size<Codec>::value;
+  if(needle.empty())
+    return std::size_t(0);
+
+  std::vector<encoded_pattern> patterns;
+  for(std::size_t offset = 0; offset < packed; ++offset)
+    patterns.push_back(encoded_pattern(needle, offset, codec));
+
+  std::size_t const chunk = find_encoded_chunk_segments * unpacked;
+  for(std::size_t first = 0; first < text_size; first += chunk) {
+    std::size_t const last = std::min(text_size, first + chunk);
+    boost::optional<std::size_t> earliest;
+    for(std::size_t i = 0; i < patterns.size(); ++i) {
+      boost::optional<std::size_t> match = find_pattern(
+          patterns[i], text, text_size, first, last, packed, unpacked);
+      if(match && (!earliest || *match < *earliest))
+        earliest = match;
+    }
+    if(earliest)
+      return earliest;
+  }
+  return boost::none;
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Looks for the bytes [needle_first, needle_last) in the data encoded by the
+// text [first, last) without decoding it, and returns the offset in the
+// decoded data of the first occurrence. The needle is encoded once for each
+// byte offset it could start at within a segment, with the characters it
+// shares with the data around it matching any character agreeing on its
+// bits, and these are looked for directly in the text. Contiguous text is
+// scanned with vector compares.
+//
+// The text must be a single line, as unwrap gives, since matches are placed
+// by counting characters from the start.
+template <
+    typename RandomAccessIterator,
+    typename NeedleIterator,
+    typename NeedleEndIterator,
+    typename Codec>
+boost::optional<std::size_t> find_encoded(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    NeedleIterator needle_first,
+    NeedleEndIterator needle_last,
+    Codec const& codec) {
+  std::vector<bits_type> needle(needle_first, needle_last);
+  return detail::find_encoded(first, last - first, needle, codec);
+}
+
+template <typename NeedleIterator, typename NeedleEndIterator, typename Codec>
+boost::optional<std::size_t> find_encoded(
+    char_type* first,
+    char_type* last,
+    NeedleIterator needle_first,
+    NeedleEndIterator needle_last,
+    Codec const& codec) {
+  return find_encoded(
+      static_cast<char_type const*>(first), static_cast<char_type const*>(last),
+      needle_first, needle_last, codec);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_FINDENCODED_HPP
@@ -0,0 +1,112 @@
+//
+// boost/radix/line_wrapping.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_LINEWRAPPING_HPP
+#define BOOST_RADIX_LINEWRAPPING_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/whitespace.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// How encoded output is split into lines. A line length of zero disables
+// wrapping. Terminators go between lines, so wrapped output never ends with
+// one.
+class line_wrapping {
+ public:
+  line_wrapping()
+      : line_length_(0)
+      , terminator_(line_terminator_lf) {
+  }
+
+  explicit line_wrapping(
+      std::size_t line_length,
+      line_terminator terminator = line_terminator_lf)
+      : line_length_(line_length)
+      , terminator_(terminator) {
+  }
+
+  // RFC 2045 section 6.8.
+  static line_wrapping mime() {
+    return line_wrapping(76, line_terminator_crlf);
+  }
+
+  // RFC 7468 section 2.
+  static line_wrapping pem() {
+    return line_wrapping(64, line_terminator_lf);
+  }
+
+  bool enabled() const {
+    return line_length_ != 0;
+  }
+
+  std::size_t line_length() const {
+    return line_length_;
+  }
+
+  line_terminator terminator() const {
+    return terminator_;
+  }
+
+  std::size_t terminator_size() const {
+    return terminator_ == line_terminator_crlf ? 2 : 1;
+  }
+
+  template <typename OutputIterator>
+  OutputIterator write_terminator(OutputIterator out) const {
+    if(terminator_ == line_terminator_crlf)
+      *out++ = '\r';
+    *out++ = '\n';
+    return out;
+  }
+
+  // Number of chars the terminators add to char_count encoded chars.
+  std::size_t wrapped_overhead(std::size_t char_count) const {
+    if(!line_length_ || !char_count)
+      return 0;
+    return (char_count - 1) / line_length_ * terminator_size();
+  }
+
+  // Number of encoded chars in wrapped_count chars of wrapped output, the
+  // inverse of adding wrapped_overhead.
+  std::size_t unwrapped_size(std::size_t wrapped_count) const {
+    if(!line_length_ || !wrapped_count)
+      return wrapped_count;
+    return wrapped_count - (wrapped_count - 1) /
+                               (line_length_ + terminator_size()) *
+                               terminator_size();
+  }
+
+ private:
+  std::size_t line_length_;
+  line_terminator terminator_;
+};
+
+// -----------------------------------------------------------------------------
+//
+namespace adl {
+
+template <typename Codec>
+line_wrapping get_line_wrapping(Codec const&) {
+  return line_wrapping(
+      codec_traits::max_encoded_line_length<Codec>::value,
+      codec_traits::encoded_line_terminator<Codec>::value);
+}
+
+} // namespace adl
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_LINEWRAPPING_HPP
@@ -0,0 +1,382 @@
+//
+// boost/radix/parallel.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_PARALLEL_HPP
+#define BOOST_RADIX_PARALLEL_HPP
+
+#include <boost/radix/common.hpp>
+
+#if BOOST_RADIX_SUPPORT_PARALLEL
+
+#  include <boost/radix/codec_traits/segment.hpp>
+#  include <boost/radix/codec_traits/whitespace.hpp>
+#  include <boost/radix/decode.hpp>
+#  include <boost/radix/detail/char_classifier.hpp>
+#  include <boost/radix/detail/parallel_chunks.hpp>
+#  include <boost/radix/encode.hpp>
+#  include <boost/radix/line_wrapping.hpp>
+#  include <boost/radix/thread_pool.hpp>
+
+#  include <boost/integer/common_factor.hpp>
+
+#  include <algorithm>
+#  include <iterator>
+#  include <vector>
+
+#  ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#  endif
+
+namespace boost { namespace radix {
+
+std::size_t const default_parallel_chunk_size = 1024 * 1024;
+
+namespace detail {
+
+// -----------------------------------------------------------------------------
+// Number of input bytes every encode chunk must be a multiple of so that the
+// chunk starts on both a segment boundary and a line boundary.
+template <typename Codec>
+std::size_t parallel_encode_alignment(line_wrapping const& wrapping) {
+  std::size_t const packed   = codec_traits::packed_segment_size<Codec>::value;
+  std::size_t const unpacked = codec_traits::unpacked_segment_size<Codec>::value;
+  std::size_t const line_length = wrapping.line_length();
+  if(!line_length)
+    return packed;
+  return boost::integer::lcm(line_length, unpacked) / unpacked * packed;
+}
+
+// The executor behind the overloads that are not given one. It is started on
+// first use and shared by every call after that, with one thread fewer than
+// the hardware as the calling thread takes chunks too.
+inline thread_pool& default_thread_pool() {
+  static thread_pool pool(
+      std::max(std::thread::hardware_concurrency(), 1u) - 1);
+  return pool;
+}
+
+inline std::size_t align_chunk_size(
+    std::size_t chunk_size, std::size_t alignment) {
+  chunk_size = std::max(chunk_size, alignment);
+  return chunk_size - (chunk_size % alignment);
+}
+
+template <
+    typename Codec,
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator>
+struct encode_chunk {
+  void operator()(std::size_t chunk) const {
+    std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    std::size_t const line_length = wrapping.line_length();
+
+    std::size_t const input_offset = chunk * chunk_size;
+    std::size_t const input_size =
+        std::min(chunk_size, source_size - input_offset);
+    std::size_t const chars_before = input_offset / packed * unpacked;
+    std::size_t output_offset      = chars_before;
+
+    // Each chunk starts on a line boundary, so it owns the terminator
+    // separating it from the previous chunk.
+    if(line_length && chunk) {
+      output_offset += chars_before / line_length * wrapping.terminator_size();
+      wrapping.write_terminator(
+          out + (output_offset - wrapping.terminator_size()));
+    }
+
+    encoder<Codec, RandomAccessOutputIterator> e(
+        codec, out + output_offset, wrapping);
+    e.append(first + input_offset, first + input_offset + input_size);
+    e.resolve();
+    if(chunk == num_chunks - 1)
+      *bytes_written = output_offset + e.bytes_written();
+  }
+
+  Codec const& codec;
+  line_wrapping wrapping;
+  RandomAccessIterator first;
+  RandomAccessOutputIterator out;
+  std::size_t source_size;
+  std::size_t chunk_size;
+  std::size_t num_chunks;
+  std::size_t* bytes_written;
+};
+
+template <
+    typename Codec,
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator>
+struct decode_chunk {
+  void operator()(std::size_t chunk) const {
+    std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+
+    std::size_t const input_offset = chunk * chunk_size;
+    std::size_t const input_size =
+        std::min(chunk_size, source_size - input_offset);
+    std::size_t const output_offset = input_offset / unpacked * packed;
+
+    decoder<Codec, RandomAccessOutputIterator> d(codec, out + output_offset);
+    d.append(first + input_offset, first + input_offset + input_size);
+    d.resolve();
+    if(chunk == num_chunks - 1)
+      *bytes_written = output_offset + d.bytes_written();
+  }
+
+  Codec const& codec;
+  RandomAccessIterator first;
+  RandomAccessOutputIterator out;
+  std::size_t source_size;
+  std::size_t chunk_size;
+  std::size_t num_chunks;
+  std::size_t* bytes_written;
+};
+
+// Counts the symbols, i.e. the characters that are not skipped, in each chunk
+// of whitespace laden input.
+template <typename Codec, typename RandomAccessIterator>
+struct count_symbols_chunk {
+  void operator()(std::size_t chunk) const {
+    std::size_t const input_offset = chunk * chunk_size;
+    std::size_t const input_size =
+        std::min(chunk_size, source_size - input_offset);
+    RandomAccessIterator begin = first + input_offset;
+    symbols[chunk] =
+        input_size - classifier.count_whitespace(begin, begin + input_size);
+  }
+
+  char_classifier<Codec> const& classifier;
+  RandomAccessIterator first;
+  std::size_t source_size;
+  std::size_t chunk_size;
+  std::size_t* symbols;
+};
+
+// Decodes the segments that start in a chunk of whitespace laden input. The
+// symbols before the first segment boundary in the chunk belong to the
+// previous chunk, and the last segment is completed from the following
+// chunks if it straddles the end.
+template <
+    typename Codec,
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator>
+struct decode_skip_whitespace_chunk {
+  void operator()(std::size_t chunk) const {
+    std::size_t const packed = codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+
+    std::size_t const input_offset = chunk * chunk_size;
+    std::size_t const input_size =
+        std::min(chunk_size, source_size - input_offset);
+    std::size_t const symbols_before = symbols[chunk];
+    std::size_t const symbols_after  = symbols[chunk + 1];
+    std::size_t const first_owned =
+        (symbols_before + unpacked - 1) / unpacked * unpacked;
+
+    ends[chunk] = 0;
+    if(first_owned >= symbols_after)
+      return;
+
+    RandomAccessIterator begin = first + input_offset;
+    RandomAccessIterator end   = begin + input_size;
+    begin = classifier.skip_symbols(begin, end, first_owned - symbols_before);
+
+    std::size_t const output_offset = first_owned / unpacked * packed;
+    decoder<Codec, RandomAccessOutputIterator> d(codec, out + output_offset);
+    decode_error_handler_skip_whitespace errh(codec);
+    d.append(begin, end, errh);
+
+    std::size_t const remainder = (symbols_after - first_owned) % unpacked;
+    if(remainder && chunk != num_chunks - 1) {
+      RandomAccessIterator last = first + source_size;
+      d.append(end, classifier.skip_symbols(end, last, unpacked - remainder),
+               errh);
+    }
+
+    d.resolve();
+    ends[chunk] = output_offset + d.bytes_written();
+  }
+
+  Codec const& codec;
+  char_classifier<Codec> const& classifier;
+  RandomAccessIterator first;
+  RandomAccessOutputIterator out;
+  std::size_t source_size;
+  std::size_t chunk_size;
+  std::size_t num_chunks;
+  std::size_t const* symbols;
+  std::size_t* ends;
+};
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Encodes [first, last) on multiple threads. The input is split into chunks of
+// roughly chunk_size bytes that start on a packed segment boundary, and on a
+// line boundary when the codec's line wrapping is enabled, so that the output
+// offset of every chunk is known up front. The output must hold
+// encoded_size(last - first, codec) chars.
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec,
+    typename Executor>
+std::size_t parallel_encode(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec,
+    Executor& executor,
+    std::size_t chunk_size = default_parallel_chunk_size) {
+  std::size_t const source_size = std::distance(first, last);
+  if(!source_size)
+    return 0;
+
+  using boost::radix::adl::get_line_wrapping;
+  line_wrapping const wrapping = get_line_wrapping(codec);
+  chunk_size = detail::align_chunk_size(
+      chunk_size, detail::parallel_encode_alignment<Codec>(wrapping));
+  std::size_t const num_chunks = (source_size + chunk_size - 1) / chunk_size;
+  std::size_t bytes_written    = 0;
+
+  detail::encode_chunk<Codec, RandomAccessIterator, RandomAccessOutputIterator>
+      body = {codec,       wrapping,   first,      out,
+              source_size, chunk_size, num_chunks, &bytes_written};
+  detail::parallel_chunks(num_chunks).run(body, executor);
+  return bytes_written;
+}
+
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec>
+std::size_t parallel_encode(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec) {
+  return parallel_encode(
+      first, last, out, codec, detail::default_thread_pool());
+}
+
+// -----------------------------------------------------------------------------
+// Decodes [first, last) on multiple threads. The input is split into chunks of
+// roughly chunk_size chars that start on an unpacked segment boundary. The
+// input must not contain characters that are skipped during decoding. The
+// output must hold decoded_size(last - first, codec) bytes. If any chunk
+// fails to decode, the first error is rethrown once all threads have
+// finished.
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec,
+    typename Executor>
+std::size_t parallel_decode(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec,
+    Executor& executor,
+    std::size_t chunk_size = default_parallel_chunk_size) {
+  std::size_t const source_size = std::distance(first, last);
+  if(!source_size)
+    return 0;
+
+  chunk_size = detail::align_chunk_size(
+      chunk_size, codec_traits::unpacked_segment_size<Codec>::value);
+  std::size_t const num_chunks = (source_size + chunk_size - 1) / chunk_size;
+  std::size_t bytes_written    = 0;
+
+  detail::decode_chunk<Codec, RandomAccessIterator, RandomAccessOutputIterator>
+      body = {codec,      first,      out,           source_size,
+              chunk_size, num_chunks, &bytes_written};
+  detail::parallel_chunks(num_chunks).run(body, executor);
+  return bytes_written;
+}
+
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec>
+std::size_t parallel_decode(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec) {
+  return parallel_decode(
+      first, last, out, codec, detail::default_thread_pool());
+}
+
+// -----------------------------------------------------------------------------
+// Decodes whitespace laden input, such as line wrapped MIME or PEM data, on
+// multiple threads. Whitespace is skipped as per
+// decode_error_handler_skip_whitespace. Segment boundaries can't be found
+// without scanning from the start, so this runs in two parallel passes: the
+// first counts the symbols in each chunk, a prefix sum over the counts gives
+// every chunk its exact segment and output offsets, and the second decodes
+// the chunks independently.
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec,
+    typename Executor>
+std::size_t parallel_decode_skip_whitespace(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec,
+    Executor& executor,
+    std::size_t chunk_size = default_parallel_chunk_size) {
+  std::size_t const source_size = std::distance(first, last);
+  if(!source_size)
+    return 0;
+
+  chunk_size                   = std::max<std::size_t>(chunk_size, 1);
+  std::size_t const num_chunks = (source_size + chunk_size - 1) / chunk_size;
+  detail::char_classifier<Codec> classifier(codec);
+
+  std::vector<std::size_t> symbols(num_chunks + 1);
+  detail::count_symbols_chunk<Codec, RandomAccessIterator> count = {
+      classifier, first, source_size, chunk_size, &symbols[1]};
+  detail::parallel_chunks(num_chunks).run(count, executor);
+
+  for(std::size_t i = 1; i <= num_chunks; ++i)
+    symbols[i] += symbols[i - 1];
+
+  std::vector<std::size_t> ends(num_chunks);
+  detail::decode_skip_whitespace_chunk<
+      Codec, RandomAccessIterator, RandomAccessOutputIterator>
+      decode = {codec,       classifier, first,       out,    source_size,
+                chunk_size,  num_chunks, &symbols[0], &ends[0]};
+  detail::parallel_chunks(num_chunks).run(decode, executor);
+  return *std::max_element(ends.begin(), ends.end());
+}
+
+template <
+    typename RandomAccessIterator,
+    typename RandomAccessOutputIterator,
+    typename Codec>
+std::size_t parallel_decode_skip_whitespace(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    RandomAccessOutputIterator out,
+    Codec const& codec) {
+  return parallel_decode_skip_whitespace(
+      first, last, out, codec, detail::default_thread_pool());
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_SUPPORT_PARALLEL
+
+#endif // BOOST_RADIX_PARALLEL_HPP
@@ -0,0 +1,174 @@
+//
+// boost/radix/resume_encoder.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_RESUMEENCODER_HPP
+#define BOOST_RADIX_RESUMEENCODER_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/exception.hpp>
+#include <boost/radix/line_wrapping.hpp>
+
+#include <boost/array.hpp>
+#include <boost/next_prior.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <iterator>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// Sets up e to carry on from the encoded text [first, last), as written by an
+// encoder with the same codec and line wrapping, so more bytes can be
+// appended without decoding the rest of it. Only the final segment is
+// decoded, and only if it is padded, so the cost doesn't depend on the
+// length of the text.
+//
+// Returns where e's output continues from: the start of a padded final
+// segment, which e writes again with the new bytes, or otherwise the end of
+// the last symbol. Anything from there on, such as a final line break, has to
+// be removed from the text before e writes to it. Characters outside the
+// alphabet throw, as do symbols following the padding.
+template <typename Codec, typename OutputIterator, typename BidirectionalIterator>
+BidirectionalIterator resume_encoder(
+    encoder<Codec, OutputIterator>& e,
+    BidirectionalIterator first,
+    BidirectionalIterator last) {
+  using boost::radix::adl::validate_character;
+  Codec const& codec = e.codec();
+  decode_error_handler_skip_whitespace errh(codec);
+
+  std::size_t const unpacked =
+      codec_traits::unpacked_segment_size<Codec>::value;
+  std::size_t const bits = codec_traits::required_bits<Codec>::value;
+  char_type const pad    = codec.get_pad_char();
+
+  // Walk back over the final segment, which is the last unpacked_segment_size
+  // symbols because only codecs whose segments can end part way through use
+  // padding.
+  boost::array<char_type, codec_traits::unpacked_segment_size<Codec>::value>
+      segment;
+  std::size_t symbols = 0;
+  std::size_t pads    = 0;
+  char_type following = 0;
+  BidirectionalIterator segment_first = last;
+  BidirectionalIterator symbols_last  = last;
+  for(BidirectionalIterator i = last; i != first && symbols + pads < unpacked;) {
+    char_type c = *--i;
+    if(validate_character(codec, c, errh) != decode_validation::op_consume)
+      continue;
+
+    if(!symbols && !pads)
+      symbols_last = boost::next(i);
+
+    if(c == pad) {
+      if(symbols)
+        BOOST_THROW_EXCEPTION(invalid_padding(following));
+      ++pads;
+    } else {
+      following = c;
+      segment[unpacked - ++symbols - pads] = c;
+    }
+    segment_first = i;
+  }
+
+  // A complete final segment stays as it is. So does text too short to make
+  // a segment, unless it can be decoded.
+  bool const partial = pads || (symbols && symbols < unpacked);
+  std::size_t const bytes = symbols * bits / 8;
+  if(partial && (!bytes || symbols * bits % 8 >= bits ||
+                 (pads && symbols + pads != unpacked)))
+    BOOST_THROW_EXCEPTION(invalid_padding(pad));
+
+  BidirectionalIterator const resume_point =
+      partial ? segment_first : symbols_last;
+
+  // The length of the current line is only needed if it can fill up.
+  std::size_t line_position = 0;
+  if(e.wrapping().enabled()) {
+    for(BidirectionalIterator i = resume_point;
+        i != first && validate_character(codec, *boost::prior(i), errh) ==
+                          decode_validation::op_consume;
+        --i) {
+      ++line_position;
+    }
+  }
+
+  boost::array<bits_type, codec_traits::unpacked_segment_size<Codec>::value>
+      unpacked_segment;
+  boost::array<bits_type, codec_traits::packed_segment_size<Codec>::value>
+      packed_segment;
+  if(partial) {
+    std::size_t const offset = unpacked - pads - symbols;
+    for(std::size_t i = 0; i < unpacked; ++i) {
+      unpacked_segment[i] =
+          i < symbols ? codec.bits_from_char(segment[offset + i]) : 0;
+    }
+    using boost::radix::adl::get_segment_packer;
+    get_segment_packer(codec)(
+        unpacked_segment.begin(), packed_segment.begin());
+  }
+
+  e.resume(
+      packed_segment.begin(), packed_segment.begin() + (partial ? bytes : 0),
+      line_position);
+  return resume_point;
+}
+
+// -----------------------------------------------------------------------------
+// Appends the encoding of [first, last) to the text in encoded, which must
+// have been written with the same codec and line wrapping, as if the bytes
+// had been encoded along with the originals. Only the final segment of the
+// existing text is read and written again. Container needs bidirectional
+// iterators, erase and push_back, as std::string does. Returns the number of
+// characters written from the start of that final segment.
+template <
+    typename Container,
+    typename InputIterator,
+    typename InputEndIterator,
+    typename Codec>
+std::size_t append_encoded(
+    Container& encoded,
+    InputIterator first,
+    InputEndIterator last,
+    Codec const& codec,
+    line_wrapping wrapping) {
+  encoder<Codec, std::back_insert_iterator<Container> > e(
+      codec, std::back_inserter(encoded), wrapping);
+  encoded.erase(resume_encoder(e, encoded.begin(), encoded.end()), encoded.end());
+  e.append(first, last);
+  e.resolve();
+  return e.bytes_written();
+}
+
+template <
+    typename Container,
+    typename InputIterator,
+    typename InputEndIterator,
+    typename Codec>
+std::size_t append_encoded(
+    Container& encoded,
+    InputIterator first,
+    InputEndIterator last,
+    Codec const& codec) {
+  using boost::radix::adl::get_line_wrapping;
+  return append_encoded(encoded, first, last, codec, get_line_wrapping(codec));
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_RESUMEENCODER_HPP
@@ -0,0 +1,323 @@
+//
+// boost/radix/rewrap.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_REWRAP_HPP
+#define BOOST_RADIX_REWRAP_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/pad.hpp>
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/char_classifier.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/symbol_table.hpp>
+#include <boost/radix/exception.hpp>
+#include <boost/radix/line_wrapping.hpp>
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+namespace detail {
+
+// Padding that can't be decoded is reported as the exception or error code
+// the library's handlers use for it. Other handlers are passed the character
+// as one outside the alphabet.
+template <typename Codec, typename ErrorHandler>
+decode_validation::op
+handle_invalid_padding(Codec const& codec, char_type c, ErrorHandler& errh) {
+  return errh.handle_nonalphabet_character(codec, c);
+}
+
+template <typename Codec>
+decode_validation::op handle_invalid_padding(
+    Codec const&, char_type c, decode_error_handler_throw&) {
+  BOOST_THROW_EXCEPTION(invalid_padding(c));
+  return decode_validation::op_abort;
+}
+
+template <typename Codec>
+decode_validation::op handle_invalid_padding(
+    Codec const&, char_type c, decode_error_handler_skip_whitespace&) {
+  BOOST_THROW_EXCEPTION(invalid_padding(c));
+  return decode_validation::op_abort;
+}
+
+template <typename Codec, typename ErrorCodeType>
+decode_validation::op handle_invalid_padding(
+    Codec const&,
+    char_type,
+    decode_error_handler_error_code<ErrorCodeType>& errh) {
+  errh.errc_ = decode_validation::invalid_padding;
+  return decode_validation::op_abort;
+}
+
+template <typename Codec, typename ErrorCodeType>
+decode_validation::op handle_invalid_padding(
+    Codec const&,
+    char_type,
+    decode_error_handler_skip_whitespace_error_code<ErrorCodeType>& errh) {
+  errh.errc_ = decode_validation::invalid_padding;
+  return decode_validation::op_abort;
+}
+
+// Copies the symbols of encoded text to out, splitting them into lines as
+// it goes. Padding is dropped on the way in and written again at the end,
+// once the number of symbols is known.
+template <typename Codec, typename OutputIterator, typename ErrorHandler>
+class rewrapper {
+ public:
+  rewrapper(
+      Codec const& codec,
+      OutputIterator out,
+      line_wrapping wrapping,
+      ErrorHandler& errh)
+      : codec_(codec)
+      , out_(out)
+      , wrapping_(wrapping)
+      , errh_(errh)
+      , chars_written_(0)
+      , line_position_(0)
+      , symbols_(0)
+      , pads_(0) {
+  }
+
+  // Returns false if the error handler aborted.
+  template <typename Iterator, typename EndIterator>
+  bool append(Iterator first, EndIterator last) {
+    for(; first != last; ++first) {
+      if(!put(*first))
+        return false;
+    }
+    return true;
+  }
+
+  bool append(char_type const* first, char_type const* last) {
+    if(last - first >= static_cast<std::ptrdiff_t>(char_classifier_threshold))
+      first = append_blocks(first, last);
+    return first && append<char_type const*>(first, last);
+  }
+
+  bool append(char_type* first, char_type* last) {
+    return append(
+        static_cast<char_type const*>(first),
+        static_cast<char_type const*>(last));
+  }
+
+  // The final segment has to hold a whole number of bytes, and any padding
+  // the input had must have completed it, as resume_encoder requires. If
+  // not, the error goes to the handler and no padding is written.
+  std::size_t resolve() {
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    std::size_t const bits = codec_traits::required_bits<Codec>::value;
+    std::size_t const group = symbols_ % unpacked;
+    char_type const pad     = codec_.get_pad_char();
+    if((group || pads_) &&
+       (group * bits < 8 || group * bits % 8 >= bits ||
+        (pads_ && group + pads_ != unpacked))) {
+      handle_invalid_padding(codec_, pad, errh_);
+      return chars_written_;
+    }
+
+    if(codec_traits::requires_pad<Codec>::type::value) {
+      for(std::size_t i = group; i && i < unpacked; ++i)
+        write(&pad, 1);
+    }
+    return chars_written_;
+  }
+
+  std::size_t chars_written() const {
+    return chars_written_;
+  }
+
+ private:
+  bool put(char_type c) {
+    using boost::radix::adl::validate_character;
+    switch(validate_character(codec_, c, errh_)) {
+    case decode_validation::op_consume:
+      break;
+    case decode_validation::op_skip:
+      return true;
+    case decode_validation::op_abort:
+      return false;
+    }
+
+    // Padding can only follow the symbols of a final segment it doesn't
+    // already complete, and nothing but more padding can follow it.
+    if(c == codec_.get_pad_char()) {
+      std::size_t const group =
+          symbols_ % codec_traits::unpacked_segment_size<Codec>::value;
+      if(!group ||
+         group + pads_ == codec_traits::unpacked_segment_size<Codec>::value)
+        return padding_error(c);
+      ++pads_;
+      return true;
+    }
+
+    if(pads_)
+      return padding_error(c);
+
+    write(&c, 1);
+    ++symbols_;
+    return true;
+  }
+
+  // Anything but an abort drops the character.
+  bool padding_error(char_type c) {
+    return handle_invalid_padding(codec_, c, errh_) !=
+           decode_validation::op_abort;
+  }
+
+  // Blocks of nothing but symbols, and whitespace the handler would skip,
+  // are copied in bulk with the whitespace compacted out. Anything else,
+  // including the padding, goes through put. Returns where the blocks
+  // stopped, or null if the handler aborted.
+  char_type const* append_blocks(char_type const* first, char_type const* last) {
+    char_classifier<Codec> classifier(codec_);
+    char_set const symbols = make_symbol_char_set(codec_, classifier);
+    bool const skip_whitespace =
+        error_handler_skips_whitespace<ErrorHandler>::value;
+    char_type compacted[32];
+    for(; last - first >= 32 && !pads_; first += 32) {
+      boost::uint32_t whitespace = classifier.whitespace_mask(first);
+      if(whitespace && !skip_whitespace)
+        whitespace = 0;
+
+      if((symbols.mask(first) | whitespace) != ~boost::uint32_t(0)) {
+        if(!append<char_type const*>(first, first + 32))
+          return 0;
+        continue;
+      }
+
+      if(whitespace) {
+        std::size_t count = compress_block(first, whitespace, compacted);
+        write(compacted, count);
+        symbols_ += count;
+      } else {
+        write(first, 32);
+        symbols_ += 32;
+      }
+    }
+    return first;
+  }
+
+  // Terminators are written before the first character of the next line,
+  // so the output never ends with one.
+  void write(char_type const* first, std::size_t count) {
+    if(!wrapping_.enabled()) {
+      out_ = std::copy(first, first + count, out_);
+      chars_written_ += count;
+      return;
+    }
+
+    std::size_t const line_length = wrapping_.line_length();
+    while(count) {
+      if(line_position_ == line_length) {
+        out_ = wrapping_.write_terminator(out_);
+        chars_written_ += wrapping_.terminator_size();
+        line_position_ = 0;
+      }
+
+      std::size_t run = std::min(count, line_length - line_position_);
+      out_            = std::copy(first, first + run, out_);
+      chars_written_ += run;
+      line_position_ += run;
+      first += run;
+      count -= run;
+    }
+  }
+
+  Codec const& codec_;
+  OutputIterator out_;
+  line_wrapping wrapping_;
+  ErrorHandler& errh_;
+  std::size_t chars_written_;
+  std::size_t line_position_;
+  std::size_t symbols_;
+  std::size_t pads_;
+};
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Rewrites encoded text with its lines broken according to wrapping, without
+// decoding it. Whitespace in the input, such as the old line breaks, is
+// dropped, characters outside the alphabet throw and the padding is
+// rewritten to complete the final segment. Padding anywhere else, or a final
+// segment that can't be decoded, throws invalid_padding. A default constructed
+// line_wrapping gives a single line. Returns the number of characters
+// written.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec>
+std::size_t rewrap(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    line_wrapping wrapping) {
+  decode_error_handler_skip_whitespace errh(codec);
+  detail::rewrapper<Codec, OutputIterator, decode_error_handler_skip_whitespace>
+      r(codec, out, wrapping, errh);
+  r.append(first, last);
+  return r.resolve();
+}
+
+// As above, but characters outside the alphabet, whitespace included, are
+// passed to errh as they would be while decoding, and so is misplaced
+// padding. The library's handlers report that as invalid_padding, others see
+// it as a character outside the alphabet. If errh aborts, nothing more is
+// written, not even the padding.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec,
+    typename ErrorHandler>
+std::size_t rewrap(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec,
+    line_wrapping wrapping,
+    ErrorHandler& errh) {
+  detail::rewrapper<Codec, OutputIterator, ErrorHandler> r(
+      codec, out, wrapping, errh);
+  if(!r.append(first, last))
+    return r.chars_written();
+  return r.resolve();
+}
+
+// Joins wrapped encoded text into a single line.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename Codec>
+std::size_t unwrap(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    Codec const& codec) {
+  return rewrap(first, last, out, codec, line_wrapping());
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_REWRAP_HPP
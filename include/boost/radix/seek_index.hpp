@@ -0,0 +1,278 @@
+//
+// boost/radix/seek_index.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_SEEKINDEX_HPP
+#define BOOST_RADIX_SEEKINDEX_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode_range.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/char_classifier.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/simd.hpp>
+#include <boost/radix/detail/symbol_table.hpp>
+
+#include <boost/core/ignore_unused.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+namespace detail {
+
+// Decoded bytes between checkpoints by default, which keeps the index to
+// 8 bytes per 64KiB while a seek reads at most about 85KiB of base64.
+std::size_t const default_seek_interval = 64 * 1024;
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Where every interval'th decoded byte comes from in encoded text that may
+// contain whitespace anywhere, such as MIME or PEM, so decoding can start
+// close to any byte instead of at the beginning. Checkpoints fall at segment
+// boundaries a fixed number of decoded bytes apart, so only their encoded
+// offsets are stored.
+//
+// The index is built in one pass that counts the characters
+// validate_character consumes, 32 at a time for contiguous text. Other
+// characters are passed over, as decode_error_handler_skip_whitespace would
+// skip them; the index doesn't validate the text. It can be saved and loaded
+// with Boost.Serialization.
+class seek_index {
+ public:
+  struct checkpoint {
+    std::size_t encoded_offset;
+    std::size_t decoded_offset;
+  };
+
+  seek_index()
+      : interval_(0)
+      , symbols_(0)
+      , size_(0) {
+  }
+
+  // interval is rounded up to a whole number of segments.
+  template <typename Iterator, typename EndIterator, typename Codec>
+  seek_index(
+      Iterator first,
+      EndIterator last,
+      Codec const& codec,
+      std::size_t interval = detail::default_seek_interval)
+      : symbols_(0)
+      , size_(0) {
+    std::size_t const packed =
+        codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    interval_ = std::max<std::size_t>(1, (interval + packed - 1) / packed) *
+                packed;
+
+    detail::char_classifier<Codec> classifier(codec);
+    build(
+        first, last, detail::make_alphabet_char_set(classifier),
+        interval_ / packed * unpacked);
+  }
+
+  // Decoded bytes between checkpoints.
+  std::size_t interval() const {
+    return interval_;
+  }
+
+  // Number of symbols in the text, including any padding.
+  std::size_t symbols() const {
+    return symbols_;
+  }
+
+  // Number of characters in the text.
+  std::size_t encoded_size() const {
+    return size_;
+  }
+
+  std::size_t size() const {
+    return offsets_.size();
+  }
+
+  checkpoint operator[](std::size_t i) const {
+    checkpoint c = {static_cast<std::size_t>(offsets_[i]), i * interval_};
+    return c;
+  }
+
+  // The last checkpoint at or before decoded_offset. A decoder started at
+  // its encoded offset writes the byte at its decoded offset first.
+  checkpoint find(std::size_t decoded_offset) const {
+    BOOST_ASSERT(!offsets_.empty());
+    return (*this)[std::min(decoded_offset / interval_, offsets_.size() - 1)];
+  }
+
+  // Sizes are saved as 64 bit so an archive loads on any platform.
+  template <typename Archive>
+  void save(Archive& ar, unsigned int const) const {
+    boost::uint64_t const interval = interval_;
+    boost::uint64_t const symbols  = symbols_;
+    boost::uint64_t const size     = size_;
+    ar << interval;
+    ar << symbols;
+    ar << size;
+    ar << offsets_;
+  }
+
+  template <typename Archive>
+  void load(Archive& ar, unsigned int const) {
+    boost::uint64_t interval;
+    boost::uint64_t symbols;
+    boost::uint64_t size;
+    ar >> interval;
+    ar >> symbols;
+    ar >> size;
+    ar >> offsets_;
+    interval_ = static_cast<std::size_t>(interval);
+    symbols_  = static_cast<std::size_t>(symbols);
+    size_     = static_cast<std::size_t>(size);
+  }
+
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+ private:
+  template <typename Iterator, typename EndIterator>
+  void build(
+      Iterator first,
+      EndIterator last,
+      detail::char_set const& alphabet,
+      std::size_t symbols_per_checkpoint) {
+    for(; first != last; ++first, ++size_) {
+      if(!alphabet.contains(*first))
+        continue;
+      if(symbols_ % symbols_per_checkpoint == 0)
+        offsets_.push_back(size_);
+      ++symbols_;
+    }
+  }
+
+  void build(
+      char_type const* first,
+      char_type const* last,
+      detail::char_set const& alphabet,
+      std::size_t symbols_per_checkpoint) {
+    char_type const* const text = first;
+    std::size_t next_checkpoint = 0;
+    for(; last - first >= 32; first += 32) {
+      boost::uint32_t symbols = alphabet.mask(first);
+      std::size_t count       = detail::popcount(symbols);
+      while(symbols_ + count > next_checkpoint) {
+        boost::uint32_t remaining = symbols;
+        for(std::size_t i = symbols_; i < next_checkpoint; ++i)
+          remaining &= remaining - 1;
+        offsets_.push_back(
+            (first - text) + detail::count_trailing_zeros(remaining));
+        next_checkpoint += symbols_per_checkpoint;
+      }
+      symbols_ += count;
+    }
+
+    size_ = first - text;
+    build<char_type const*, char_type const*>(
+        first, last, alphabet, symbols_per_checkpoint);
+  }
+
+  void build(
+      char_type* first,
+      char_type* last,
+      detail::char_set const& alphabet,
+      std::size_t symbols_per_checkpoint) {
+    build(
+        static_cast<char_type const*>(first),
+        static_cast<char_type const*>(last), alphabet, symbols_per_checkpoint);
+  }
+
+  std::size_t interval_;
+  std::size_t symbols_;
+  std::size_t size_;
+  std::vector<boost::uint64_t> offsets_;
+};
+
+namespace detail {
+
+// Symbol positions found by counting forward from the checkpoint before
+// them, so a lookup reads at most one interval of text.
+template <typename RandomAccessIterator, typename Codec>
+class indexed_positions {
+ public:
+  indexed_positions(
+      seek_index const& index, RandomAccessIterator text, Codec const& codec)
+      : index_(index)
+      , text_(text)
+      , alphabet_(make_alphabet_char_set(char_classifier<Codec>(codec))) {
+  }
+
+  std::size_t symbols() const {
+    return index_.symbols();
+  }
+
+  std::size_t position(std::size_t symbol_offset) const {
+    if(symbol_offset >= index_.symbols())
+      return index_.encoded_size();
+
+    std::size_t const packed =
+        codec_traits::packed_segment_size<Codec>::value;
+    std::size_t const unpacked =
+        codec_traits::unpacked_segment_size<Codec>::value;
+    seek_index::checkpoint c =
+        index_.find(symbol_offset / unpacked * packed);
+    std::size_t symbol   = c.decoded_offset / packed * unpacked;
+    std::size_t position = c.encoded_offset;
+    for(;; ++position) {
+      if(alphabet_.contains(text_[position]) && symbol++ == symbol_offset)
+        return position;
+    }
+  }
+
+ private:
+  seek_index const& index_;
+  RandomAccessIterator text_;
+  char_set alphabet_;
+};
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// As decode_range, for text with whitespace anywhere, located with an index
+// built from the same text and codec. At most an interval of text is read
+// on top of the segments decoded.
+template <typename RandomAccessIterator, typename OutputIterator, typename Codec>
+std::size_t decode_range(
+    RandomAccessIterator first,
+    RandomAccessIterator last,
+    std::size_t byte_first,
+    std::size_t byte_last,
+    OutputIterator out,
+    Codec const& codec,
+    seek_index const& index) {
+  BOOST_ASSERT(index.encoded_size() == std::size_t(last - first));
+  boost::ignore_unused(last);
+  decode_error_handler_skip_whitespace errh(codec);
+  return detail::decode_range(
+      first, byte_first, byte_last, out, codec,
+      detail::indexed_positions<RandomAccessIterator, Codec>(
+          index, first, codec),
+      errh);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_SEEKINDEX_HPP
@@ -14,34 +14,92 @@
 
 #include <boost/radix/bitmask.hpp>
 #include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/bmi2_bitstream.hpp>
+#include <boost/radix/detail/segment_runs.hpp>
 
 #include <boost/cstdint.hpp>
 
 namespace boost { namespace radix {
+namespace detail {
+
+template <std::size_t Bits, typename RandomAccessIterator, typename UnpackedSegment>
+void unpack_lsb_basic(RandomAccessIterator bytes, UnpackedSegment& u) {
+  using namespace bits;
+  std::size_t const unpacked_size = to_unpacked_segment_size<Bits>::value;
+  std::size_t const packed_size   = to_packed_segment_size<Bits>::value;
+
+  BOOST_STATIC_ASSERT(packed_size <= sizeof(boost::uint64_t));
+
+  boost::uint64_t packed = 0;
+  for(std::size_t i = 0; i < packed_size; ++i) {
+    packed |= boost::uint64_t(*bytes++) << (i * 8);
+  }
+
+  for(std::size_t i = 0; i < unpacked_size; ++i) {
+    u[i] = static_cast<char_type>(packed & mask<Bits>::value);
+    packed >>= Bits;
+  }
+}
+
+template <std::size_t Bits, typename RandomAccessIterator, typename UnpackedSegment>
+void unpack_lsb(RandomAccessIterator packed, UnpackedSegment& u) {
+  unpack_lsb_basic<Bits>(packed, u);
+}
+
+#if BOOST_RADIX_SIMD_BMI2
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_lsb(bits_type const* packed, UnpackedSegment& u) {
+  typedef bmi2_bitstream<Bits, bit_order_lsb_first> stream_type;
+  if(stream_type::preferred && sizeof(u[0]) == 1 && bmi2_dispatch<>::fast)
+    stream_type::unpack(packed, &u[0]);
+  else
+    unpack_lsb_basic<Bits>(packed, u);
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_lsb(bits_type* packed, UnpackedSegment& u) {
+  unpack_lsb<Bits>(static_cast<bits_type const*>(packed), u);
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_lsb(char_type const* packed, UnpackedSegment& u) {
+  unpack_lsb<Bits>(reinterpret_cast<bits_type const*>(packed), u);
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_lsb(char_type* packed, UnpackedSegment& u) {
+  unpack_lsb<Bits>(reinterpret_cast<bits_type const*>(packed), u);
+}
+#endif
+
+} // namespace detail
 
 template <std::size_t Bits>
 class static_ibitstream_lsb {
  public:
   template <typename RandomAccessIterator, typename UnpackedSegment>
   void operator()(RandomAccessIterator bytes, UnpackedSegment& u) const {
-    using namespace bits;
-    std::size_t const unpacked_size = to_unpacked_segment_size<Bits>::value;
-    std::size_t const packed_size   = to_packed_segment_size<Bits>::value;
-
-    BOOST_STATIC_ASSERT(packed_size <= sizeof(boost::uint64_t));
-
-    boost::uint64_t packed = 0;
-    for(std::size_t i = 0; i < packed_size; ++i) {
-      packed |= boost::uint64_t(*bytes++) << (i * 8);
-    }
-
-    for(std::size_t i = 0; i < unpacked_size; ++i) {
-      u[i] = static_cast<char_type>(packed & mask<Bits>::value);
-      packed >>= Bits;
-    }
+    detail::unpack_lsb<Bits>(bytes, u);
   }
 };
 
+namespace detail {
+
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    std::size_t Bits,
+    typename RandomAccessIterator>
+void unpack_segments(
+    static_ibitstream_lsb<Bits> const& segment_unpacker,
+    RandomAccessIterator packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_segment_blocks<bit_order_lsb_first, Bits>(
+      segment_unpacker, packed, segments, symbols);
+}
+
+} // namespace detail
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_STATICIBITSTREAMLSB_HPP
@@ -14,6 +14,8 @@
 
 #include <boost/radix/bitmask.hpp>
 #include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/bmi2_bitstream.hpp>
+#include <boost/radix/detail/segment_runs.hpp>
 #include <boost/type_traits/integral_constant.hpp>
 
 #include <boost/cstdint.hpp>
@@ -152,6 +154,39 @@ void unpack_basic(
     all_bits >>= Bits;
   }
 }
+template <std::size_t Bits, typename RandomAccessIterator, typename UnpackedSegment>
+void unpack_msb(RandomAccessIterator packed, UnpackedSegment& u) {
+  unpack(packed, u, boost::integral_constant<std::size_t, Bits>());
+}
+
+#if BOOST_RADIX_SIMD_BMI2
+// Segments in memory take a single pdep for the widths where the shift
+// ladder is long.
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_msb(bits_type const* packed, UnpackedSegment& u) {
+  typedef bmi2_bitstream<Bits, bit_order_msb_first> stream_type;
+  if(stream_type::preferred && sizeof(u[0]) == 1 && bmi2_dispatch<>::fast)
+    stream_type::unpack(packed, &u[0]);
+  else
+    unpack(packed, u, boost::integral_constant<std::size_t, Bits>());
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_msb(bits_type* packed, UnpackedSegment& u) {
+  unpack_msb<Bits>(static_cast<bits_type const*>(packed), u);
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_msb(char_type const* packed, UnpackedSegment& u) {
+  unpack_msb<Bits>(reinterpret_cast<bits_type const*>(packed), u);
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+void unpack_msb(char_type* packed, UnpackedSegment& u) {
+  unpack_msb<Bits>(reinterpret_cast<bits_type const*>(packed), u);
+}
+#endif
+
 } // namespace detail
 
 template <std::size_t Bits>
@@ -159,10 +194,28 @@ class static_ibitstream_msb {
  public:
   template <typename RandomAccessIterator, typename UnpackedSegment>
   void operator()(RandomAccessIterator packed, UnpackedSegment& u) const {
-    return detail::unpack(
-        packed, u, boost::integral_constant<std::size_t, Bits>());
+    detail::unpack_msb<Bits>(packed, u);
   }
 };
+
+namespace detail {
+
+// The MSB unpacker reading from memory goes a vector at a time.
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    std::size_t Bits,
+    typename RandomAccessIterator>
+void unpack_segments(
+    static_ibitstream_msb<Bits> const& segment_unpacker,
+    RandomAccessIterator packed,
+    std::size_t segments,
+    bits_type* symbols) {
+  unpack_segment_blocks<bit_order_msb_first, Bits>(
+      segment_unpacker, packed, segments, symbols);
+}
+
+} // namespace detail
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_STATICIBITSTREAMMSB_HPP
@@ -1,5 +1,5 @@
 //
-// boost/radix/static_ibitstream_lsb.hpp
+// boost/radix/static_obitstream_lsb.hpp
 //
 // Copyright (c) Chris Glover, 2017-2018
 //
@@ -14,6 +14,8 @@
 
 #include <boost/radix/bitmask.hpp>
 #include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/bmi2_bitstream.hpp>
+#include <boost/radix/detail/segment_runs.hpp>
 
 #include <boost/cstdint.hpp>
 
@@ -22,6 +24,54 @@
 #endif
 
 namespace boost { namespace radix {
+namespace detail {
+
+template <std::size_t Bits, typename UnpackedSegment, typename OutputIterator>
+OutputIterator pack_lsb_basic(UnpackedSegment const& unpacked, OutputIterator out) {
+  using namespace bits;
+  std::size_t const unpacked_size = to_unpacked_segment_size<Bits>::value;
+  std::size_t const packed_size   = to_packed_segment_size<Bits>::value;
+
+  BOOST_STATIC_ASSERT(packed_size <= sizeof(boost::uint64_t));
+
+  boost::uint64_t packed = 0;
+  for(std::size_t i = 0; i < unpacked_size; ++i) {
+    packed |= boost::uint64_t(unpacked[i]) << (i * Bits);
+  }
+
+  for(std::size_t i = 0; i < packed_size; ++i) {
+    *out++ = static_cast<bits_type>(packed & mask<8>::value);
+    packed >>= 8;
+  }
+
+  return out;
+}
+
+template <std::size_t Bits, typename UnpackedSegment, typename OutputIterator>
+OutputIterator pack_lsb(UnpackedSegment const& unpacked, OutputIterator out) {
+  return pack_lsb_basic<Bits>(unpacked, out);
+}
+
+#if BOOST_RADIX_SIMD_BMI2
+template <std::size_t Bits, typename UnpackedSegment>
+bits_type* pack_lsb(UnpackedSegment const& unpacked, bits_type* out) {
+  typedef bmi2_bitstream<Bits, bit_order_lsb_first> stream_type;
+  if(!stream_type::preferred || sizeof(unpacked[0]) != 1 ||
+     !bmi2_dispatch<>::fast)
+    return pack_lsb_basic<Bits>(unpacked, out);
+
+  stream_type::pack(&unpacked[0], out);
+  return out + stream_type::packed_segment_size;
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+char_type* pack_lsb(UnpackedSegment const& unpacked, char_type* out) {
+  return reinterpret_cast<char_type*>(
+      pack_lsb<Bits>(unpacked, reinterpret_cast<bits_type*>(out)));
+}
+#endif
+
+} // namespace detail
 
 template <std::size_t Bits>
 class static_obitstream_lsb {
@@ -29,25 +79,27 @@ class static_obitstream_lsb {
   template <typename UnpackedSegment, typename OutputIterator>
   OutputIterator operator()(
       UnpackedSegment const& unpacked, OutputIterator out) const {
-    using namespace bits;
-    std::size_t const unpacked_size = to_unpacked_segment_size<Bits>::value;
-    std::size_t const packed_size   = to_packed_segment_size<Bits>::value;
-
-    BOOST_STATIC_ASSERT(packed_size <= sizeof(boost::uint64_t));
+    return detail::pack_lsb<Bits>(unpacked, out);
+  }
+};
 
-    boost::uint64_t packed = 0;
-    for(std::size_t i = 0; i < unpacked_size; ++i) {
-      packed |= boost::uint64_t(unpacked[i]) << (i * Bits);
-    }
+namespace detail {
 
-    for(std::size_t i = 0; i < packed_size; ++i) {
-      *out++ = static_cast<bits_type>(packed & mask<8>::value);
-      packed >>= 8;
-    }
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    std::size_t Bits,
+    typename OutputIterator>
+OutputIterator pack_segments(
+    static_obitstream_lsb<Bits> const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    OutputIterator out) {
+  return pack_segment_blocks<bit_order_lsb_first, Bits>(
+      segment_packer, symbols, segments, out);
+}
 
-    return out;
-  }
-};
+} // namespace detail
 
 }} // namespace boost::radix
 
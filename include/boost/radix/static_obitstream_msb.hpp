@@ -14,6 +14,8 @@
 
 #include <boost/radix/bitmask.hpp>
 #include <boost/radix/detail/bits.hpp>
+#include <boost/radix/detail/bmi2_bitstream.hpp>
+#include <boost/radix/detail/segment_runs.hpp>
 #include <boost/type_traits/integral_constant.hpp>
 
 #include <boost/cstdint.hpp>
@@ -140,6 +142,32 @@ OutputIterator pack_basic(
   return out;
 }
 
+template <std::size_t Bits, typename UnpackedSegment, typename OutputIterator>
+OutputIterator pack_msb(UnpackedSegment const& unpacked, OutputIterator out) {
+  return pack(unpacked, out, boost::integral_constant<std::size_t, Bits>());
+}
+
+#if BOOST_RADIX_SIMD_BMI2
+// Segments written to memory take a single pext for the widths where the
+// shift ladder is long.
+template <std::size_t Bits, typename UnpackedSegment>
+bits_type* pack_msb(UnpackedSegment const& unpacked, bits_type* out) {
+  typedef bmi2_bitstream<Bits, bit_order_msb_first> stream_type;
+  if(!stream_type::preferred || sizeof(unpacked[0]) != 1 ||
+     !bmi2_dispatch<>::fast)
+    return pack(unpacked, out, boost::integral_constant<std::size_t, Bits>());
+
+  stream_type::pack(&unpacked[0], out);
+  return out + stream_type::packed_segment_size;
+}
+
+template <std::size_t Bits, typename UnpackedSegment>
+char_type* pack_msb(UnpackedSegment const& unpacked, char_type* out) {
+  return reinterpret_cast<char_type*>(
+      pack_msb<Bits>(unpacked, reinterpret_cast<bits_type*>(out)));
+}
+#endif
+
 } // namespace detail
 
 template <std::size_t Bits>
@@ -148,11 +176,28 @@ class static_obitstream_msb {
   template <typename UnpackedSegment, typename OutputIterator>
   OutputIterator operator()(
       UnpackedSegment const& unpacked, OutputIterator out) const {
-    return detail::pack(
-        unpacked, out, boost::integral_constant<std::size_t, Bits>());
+    return detail::pack_msb<Bits>(unpacked, out);
   }
 };
 
+namespace detail {
+
+template <
+    std::size_t PackedSegmentSize,
+    std::size_t UnpackedSegmentSize,
+    std::size_t Bits,
+    typename OutputIterator>
+OutputIterator pack_segments(
+    static_obitstream_msb<Bits> const& segment_packer,
+    bits_type const* symbols,
+    std::size_t segments,
+    OutputIterator out) {
+  return pack_segment_blocks<bit_order_msb_first, Bits>(
+      segment_packer, symbols, segments, out);
+}
+
+} // namespace detail
+
 }} // namespace boost::radix
 
 #endif // BOOST_RADIX_STATICOBITSTREAMMSB_HPP
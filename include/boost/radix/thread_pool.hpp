@@ -0,0 +1,104 @@
+//
+// boost/radix/thread_pool.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_THREADPOOL_HPP
+#define BOOST_RADIX_THREADPOOL_HPP
+
+#include <boost/radix/common.hpp>
+
+#if BOOST_RADIX_SUPPORT_PARALLEL
+
+#  include <boost/noncopyable.hpp>
+
+#  include <condition_variable>
+#  include <deque>
+#  include <functional>
+#  include <mutex>
+#  include <thread>
+#  include <vector>
+
+#  ifdef BOOST_HAS_PRAGMA_ONCE
+#    pragma once
+#  endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+// Minimal executor used by the parallel algorithms when the user does not
+// supply one. Any type with an execute(Function) member that eventually runs
+// the function can be used in its place, and if it has a size() member too, no
+// more workers than that are posted to it. A pool with no threads runs each
+// function inline.
+class thread_pool : boost::noncopyable {
+ public:
+  explicit thread_pool(
+      std::size_t num_threads = std::thread::hardware_concurrency())
+      : stop_(false) {
+    threads_.reserve(num_threads);
+    for(std::size_t i = 0; i < num_threads; ++i)
+      threads_.push_back(std::thread(&thread_pool::run, this));
+  }
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for(std::size_t i = 0; i < threads_.size(); ++i)
+      threads_[i].join();
+  }
+
+  template <typename Function>
+  void execute(Function f) {
+    if(threads_.empty()) {
+      f();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(f);
+    }
+    ready_.notify_one();
+  }
+
+  std::size_t size() const {
+    return threads_.size();
+  }
+
+ private:
+  void run() {
+    while(true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while(!stop_ && tasks_.empty())
+          ready_.wait(lock);
+        if(tasks_.empty())
+          return;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::deque<std::function<void()> > tasks_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  bool stop_;
+};
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_SUPPORT_PARALLEL
+
+#endif // BOOST_RADIX_THREADPOOL_HPP
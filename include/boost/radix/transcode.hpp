@@ -0,0 +1,231 @@
+//
+// boost/radix/transcode.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_TRANSCODE_HPP
+#define BOOST_RADIX_TRANSCODE_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/bit_order.hpp>
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_sink.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/alphabet_translator.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/line_wrapping.hpp>
+
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <algorithm>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+namespace detail {
+
+// Passes decoded output straight on to an encoder, so input is decoded a
+// chunk at a time into a buffer that stays in cache and encoded from there.
+template <typename Encoder>
+class encoder_sink {
+ public:
+  explicit encoder_sink(Encoder& e)
+      : encoder_(&e) {
+  }
+
+  void operator()(bits_type const* data, std::size_t size) const {
+    encoder_->append(data, data + size);
+  }
+
+ private:
+  Encoder* encoder_;
+};
+
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename FromCodec,
+    typename ToCodec,
+    typename ErrorHandler>
+std::size_t transcode_segments(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    FromCodec const& from,
+    ToCodec const& to,
+    ErrorHandler& errh) {
+  typedef encoder<ToCodec, OutputIterator> encoder_type;
+  encoder_type e(to, out);
+  sink_decoder<FromCodec, encoder_sink<encoder_type> > d(
+      from, encoder_sink<encoder_type>(e));
+  d.append(first, last, errh);
+  d.resolve();
+  e.resolve();
+  return e.bytes_written();
+}
+
+template <typename FromCodec, typename ToCodec>
+struct same_segments
+    : boost::integral_constant<
+          bool,
+          codec_traits::required_bits<FromCodec>::value ==
+                  codec_traits::required_bits<ToCodec>::value &&
+              codec_traits::segment_bit_order<FromCodec>::value ==
+                  codec_traits::segment_bit_order<ToCodec>::value> {};
+
+// Every segment but the last is translated a character at a time. The last
+// goes through the decoder and encoder so its padding comes out as the
+// target codec would write it.
+template <typename OutputIterator, typename FromCodec, typename ToCodec>
+std::size_t translate(
+    char_type const* first,
+    char_type const* last,
+    OutputIterator out,
+    FromCodec const& from,
+    ToCodec const& to,
+    decode_error_handler_throw& errh) {
+  std::size_t const unpacked =
+      codec_traits::unpacked_segment_size<FromCodec>::value;
+  std::size_t const size = last - first;
+  char_type const* body_last =
+      first + (size > unpacked ? (size - 1) / unpacked * unpacked : 0);
+
+  alphabet_translator<FromCodec, ToCodec> translator(from, to);
+  char_type block[alphabet_translator<FromCodec, ToCodec>::block_size];
+  std::size_t const block_size = sizeof(block);
+  std::size_t const body_size  = body_last - first;
+  while(first != body_last) {
+    std::size_t count = std::min<std::size_t>(body_last - first, block_size);
+    if(count < block_size || !translator.translate_block(first, block)) {
+      // Anything outside the alphabet goes to validate_character, which
+      // throws just as decode would.
+      for(std::size_t i = 0; i < count; ++i) {
+        if(!translator.contains(first[i])) {
+          using boost::radix::adl::validate_character;
+          validate_character(from, first[i], errh);
+        }
+        block[i] = translator.translate(first[i]);
+      }
+    }
+    out = std::copy(block, block + count, out);
+    first += count;
+  }
+
+  return body_size + transcode_segments(first, last, out, from, to, errh);
+}
+
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename FromCodec,
+    typename ToCodec,
+    typename SameSegments>
+std::size_t transcode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    FromCodec const& from,
+    ToCodec const& to,
+    SameSegments) {
+  decode_error_handler_throw errh(from);
+  return transcode_segments(first, last, out, from, to, errh);
+}
+
+template <typename OutputIterator, typename FromCodec, typename ToCodec>
+std::size_t transcode(
+    char_type const* first,
+    char_type const* last,
+    OutputIterator out,
+    FromCodec const& from,
+    ToCodec const& to,
+    boost::true_type) {
+  using boost::radix::adl::get_line_wrapping;
+  decode_error_handler_throw errh(from);
+  if(last - first >= static_cast<std::ptrdiff_t>(char_classifier_threshold) &&
+     !get_line_wrapping(to).enabled())
+    return translate(first, last, out, from, to, errh);
+
+  return transcode_segments(first, last, out, from, to, errh);
+}
+
+template <typename OutputIterator, typename FromCodec, typename ToCodec>
+std::size_t transcode(
+    char_type* first,
+    char_type* last,
+    OutputIterator out,
+    FromCodec const& from,
+    ToCodec const& to,
+    boost::true_type same) {
+  return transcode(
+      static_cast<char_type const*>(first),
+      static_cast<char_type const*>(last), out, from, to, same);
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Converts text encoded with from_codec to text encoded with to_codec without
+// decoding the whole input into a temporary buffer. Returns the number of
+// characters written. Bad input throws as decode does.
+//
+// Contiguous input is decoded a chunk at a time into a small buffer that is
+// encoded straight away. When both codecs pack the same number of bits per
+// character in the same order, as base64 and base64url do, and to_codec
+// doesn't wrap lines, all but the final segment is translated character for
+// character instead, with vector compares when only a few characters differ.
+// Padding is only interpreted in the final segment.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename FromCodec,
+    typename ToCodec>
+std::size_t transcode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    FromCodec const& from_codec,
+    ToCodec const& to_codec) {
+  return detail::transcode(
+      first, last, out, from_codec, to_codec,
+      typename detail::same_segments<FromCodec, ToCodec>::type());
+}
+
+// As above, but characters outside from_codec's alphabet are passed to errh
+// as they would be while decoding, so for example
+// decode_error_handler_skip_whitespace allows line wrapped input. Input
+// always goes through the decoder and encoder. If errh aborts, as
+// decode_error_handler_error_code does, transcoding stops there and the
+// output is the whole segments before the offending character.
+template <
+    typename InputIterator,
+    typename InputEndIterator,
+    typename OutputIterator,
+    typename FromCodec,
+    typename ToCodec,
+    typename ErrorHandler>
+std::size_t transcode(
+    InputIterator first,
+    InputEndIterator last,
+    OutputIterator out,
+    FromCodec const& from_codec,
+    ToCodec const& to_codec,
+    ErrorHandler& errh) {
+  return detail::transcode_segments(
+      first, last, out, from_codec, to_codec, errh);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_TRANSCODE_HPP
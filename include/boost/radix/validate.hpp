@@ -0,0 +1,271 @@
+//
+// boost/radix/validate.hpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef BOOST_RADIX_VALIDATE_HPP
+#define BOOST_RADIX_VALIDATE_HPP
+
+#include <boost/radix/common.hpp>
+
+#include <boost/radix/codec_traits/segment.hpp>
+#include <boost/radix/decode_validation.hpp>
+#include <boost/radix/detail/char_classifier.hpp>
+#include <boost/radix/detail/char_set.hpp>
+#include <boost/radix/detail/simd.hpp>
+#include <boost/radix/detail/symbol_table.hpp>
+
+#include <boost/cstdint.hpp>
+
+#ifdef BOOST_HAS_PRAGMA_ONCE
+#  pragma once
+#endif
+
+namespace boost { namespace radix {
+
+// -----------------------------------------------------------------------------
+//
+struct validation_result {
+  validation_result()
+      : error(decode_validation::none)
+      , error_offset(0)
+      , decoded_size(0) {
+  }
+
+  bool valid() const {
+    return error == decode_validation::none;
+  }
+
+  decode_validation::error error;
+
+  // Offset of the first bad character, or the length of the input when it is
+  // valid.
+  std::size_t error_offset;
+
+  // Exact number of bytes decode would write. Only meaningful when valid.
+  std::size_t decoded_size;
+};
+
+namespace detail {
+
+// Forwards to the user's handler, remembering which kind of error it was
+// asked about so an abort can be reported.
+template <typename ErrorHandler>
+struct validation_probe {
+  explicit validation_probe(ErrorHandler& errh)
+      : errh_(errh)
+      , error(decode_validation::none) {
+  }
+
+  template <typename Codec>
+  decode_validation::op
+  handle_whitespace_character(Codec const& codec, char_type c) {
+    error = decode_validation::invalid_whitespace;
+    return errh_.handle_whitespace_character(codec, c);
+  }
+
+  template <typename Codec>
+  decode_validation::op
+  handle_nonalphabet_character(Codec const& codec, char_type c) {
+    error = decode_validation::nonalphabet_character;
+    return errh_.handle_nonalphabet_character(codec, c);
+  }
+
+  ErrorHandler& errh_;
+  decode_validation::error error;
+};
+
+// Tracks what the decoder would do with each character without decoding.
+// Padding is only accepted as a run at the end of the final segment, because
+// anywhere else the decoder would write the pad bits out as data.
+template <typename Codec, typename ErrorHandler>
+class validator {
+ public:
+  validator(Codec const& codec, ErrorHandler& errh)
+      : codec_(codec)
+      , errh_(errh)
+      , symbols_(0)
+      , first_pad_(no_pad) {
+  }
+
+  bool check(char_type c) {
+    validation_probe<ErrorHandler> probe(errh_);
+    using boost::radix::adl::validate_character;
+    switch(validate_character(codec_, c, probe)) {
+    case decode_validation::op_consume:
+      break;
+    case decode_validation::op_skip:
+      ++result_.error_offset;
+      return true;
+    case decode_validation::op_abort:
+      result_.error = probe.error;
+      return false;
+    }
+
+    if(codec_.bits_from_char(c) == codec_.get_pad_bits()) {
+      std::size_t const unpacked =
+          codec_traits::unpacked_segment_size<Codec>::value;
+      if(first_pad_ == no_pad)
+        first_pad_ = symbols_;
+      else if(symbols_ / unpacked != first_pad_ / unpacked)
+        return fail(decode_validation::invalid_padding);
+    } else if(first_pad_ != no_pad) {
+      return fail(decode_validation::invalid_padding);
+    }
+
+    ++symbols_;
+    ++result_.error_offset;
+    return true;
+  }
+
+  // Accounts for count characters known to be non-pad symbols.
+  bool add_symbols(std::size_t count) {
+    if(!count)
+      return true;
+    if(first_pad_ != no_pad)
+      return fail(decode_validation::invalid_padding);
+    symbols_ += count;
+    result_.error_offset += count;
+    return true;
+  }
+
+  validation_result result() const {
+    validation_result result = result_;
+    if(result.valid())
+      result.decoded_size = decoded_size();
+    return result;
+  }
+
+ private:
+  static std::size_t const no_pad = ~std::size_t(0);
+
+  bool fail(decode_validation::error error) {
+    result_.error = error;
+    return false;
+  }
+
+  std::size_t decoded_size() const {
+    return decoded_size_of_symbols<Codec>(
+        symbols_, first_pad_ == no_pad ? symbols_ : first_pad_);
+  }
+
+  Codec const& codec_;
+  ErrorHandler& errh_;
+  std::size_t symbols_;
+  std::size_t first_pad_;
+  validation_result result_;
+};
+
+template <typename Codec, typename ErrorHandler>
+std::size_t const validator<Codec, ErrorHandler>::no_pad;
+
+template <typename Codec, typename ErrorHandler>
+validation_result validate_contiguous(
+    char_type const* first,
+    char_type const* last,
+    Codec const& codec,
+    ErrorHandler& errh) {
+  validator<Codec, ErrorHandler> v(codec, errh);
+  if(last - first >= static_cast<std::ptrdiff_t>(char_classifier_threshold)) {
+    char_classifier<Codec> classifier(codec);
+    char_set const symbols = make_symbol_char_set(codec, classifier);
+    for(; last - first >= 32; first += 32) {
+      if(symbols.all(first)) {
+        if(!v.add_symbols(32))
+          return v.result();
+        continue;
+      }
+
+      // Runs of symbols are counted in bulk and only the other characters
+      // are looked at individually.
+      boost::uint32_t others = ~symbols.mask(first);
+      std::size_t checked    = 0;
+      while(others) {
+        std::size_t i = count_trailing_zeros(others);
+        if(!v.add_symbols(i - checked) || !v.check(first[i]))
+          return v.result();
+        checked = i + 1;
+        others &= others - 1;
+      }
+
+      if(!v.add_symbols(32 - checked))
+        return v.result();
+    }
+  }
+
+  for(; first != last; ++first) {
+    if(!v.check(*first))
+      break;
+  }
+
+  return v.result();
+}
+
+template <
+    typename Iterator,
+    typename EndIterator,
+    typename Codec,
+    typename ErrorHandler>
+validation_result validate(
+    Iterator first, EndIterator last, Codec const& codec, ErrorHandler& errh) {
+  validator<Codec, ErrorHandler> v(codec, errh);
+  for(; first != last; ++first) {
+    if(!v.check(*first))
+      break;
+  }
+
+  return v.result();
+}
+
+template <typename Codec, typename ErrorHandler>
+validation_result validate(
+    char_type const* first,
+    char_type const* last,
+    Codec const& codec,
+    ErrorHandler& errh) {
+  return validate_contiguous(first, last, codec, errh);
+}
+
+template <typename Codec, typename ErrorHandler>
+validation_result validate(
+    char_type* first, char_type* last, Codec const& codec, ErrorHandler& errh) {
+  return validate_contiguous<Codec, ErrorHandler>(first, last, codec, errh);
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// Checks that [first, last) would decode without error and works out exactly
+// how many bytes it would decode to, without writing any output. Whitespace
+// is an error.
+template <typename Iterator, typename EndIterator, typename Codec>
+validation_result
+validate(Iterator first, EndIterator last, Codec const& codec) {
+  decode_validation::error ignored;
+  decode_error_handler_error_code<decode_validation::error> errh(
+      codec, ignored);
+  return detail::validate(first, last, codec, errh);
+}
+
+// As above, but characters outside the alphabet are passed to errh as they
+// would be while decoding, so for example
+// decode_error_handler_skip_whitespace_error_code allows line wrapped input.
+// A handler that throws, such as decode_error_handler_skip_whitespace,
+// throws from here too rather than filling in the result.
+template <
+    typename Iterator,
+    typename EndIterator,
+    typename Codec,
+    typename ErrorHandler>
+validation_result validate(
+    Iterator first, EndIterator last, Codec const& codec, ErrorHandler& errh) {
+  return detail::validate(first, last, codec, errh);
+}
+
+}} // namespace boost::radix
+
+#endif // BOOST_RADIX_VALIDATE_HPP
@@ -0,0 +1,102 @@
+//
+// test/batch.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestBatch
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/batch.hpp>
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+//
+template <typename Codec>
+void test_encode_batch(Codec const& codec) {
+  std::vector<bits_type> data = generate_random_bytes(64 * 65 / 2);
+  std::vector<std::vector<bits_type> > messages;
+  std::vector<bits_type>::iterator it = data.begin();
+  for(std::size_t size = 0; size <= 64; ++size) {
+    messages.push_back(std::vector<bits_type>(it, it + size));
+    it += size;
+  }
+
+  std::vector<char_type> encoded(
+      boost::radix::encoded_batch_size(messages, codec));
+  std::vector<std::size_t> offsets(messages.size() + 1);
+  std::size_t written = boost::radix::encode_batch(
+      messages, encoded.data(), offsets.begin(), codec);
+  BOOST_TEST(written == encoded.size());
+  BOOST_TEST(offsets.front() == 0);
+  BOOST_TEST(offsets.back() == written);
+
+  for(std::size_t i = 0; i < messages.size(); ++i) {
+    std::string expected;
+    boost::radix::encode(
+        messages[i].begin(), messages[i].end(), std::back_inserter(expected),
+        codec);
+    std::string actual(
+        encoded.begin() + offsets[i], encoded.begin() + offsets[i + 1]);
+    BOOST_TEST(expected == actual);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_batch_base16) {
+  test_encode_batch(boost::radix::codec::rfc4648::base16());
+}
+
+BOOST_AUTO_TEST_CASE(encode_batch_base32) {
+  test_encode_batch(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(encode_batch_base64) {
+  test_encode_batch(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(decode_batch_base64) {
+  boost::radix::codec::rfc4648::base64 codec;
+
+  std::vector<std::string> messages;
+  messages.push_back("Zm9vYmFy");
+  messages.push_back("");
+  messages.push_back("Zg==");
+  messages.push_back("Zm9v!mFy");
+  messages.push_back("Zm8=");
+  messages.push_back("Zm9v YmE=");
+  messages.push_back("Zm9vYmE=");
+
+  std::vector<bits_type> decoded(
+      boost::radix::decoded_batch_size(messages, codec));
+  std::vector<std::size_t> offsets(messages.size() + 1);
+  std::vector<boost::radix::decode_validation::error> status(messages.size());
+  std::size_t written = boost::radix::decode_batch(
+      messages, decoded.data(), offsets.begin(), status.begin(), codec);
+
+  BOOST_TEST(offsets.back() == written);
+
+  char const* expected[] = {"foobar", "", "f", "", "fo", "", "fooba"};
+  for(std::size_t i = 0; i < messages.size(); ++i) {
+    std::string actual(
+        decoded.begin() + offsets[i], decoded.begin() + offsets[i + 1]);
+    BOOST_TEST(actual == expected[i]);
+  }
+
+  BOOST_TEST(status[0] == boost::radix::decode_validation::none);
+  BOOST_TEST(status[1] == boost::radix::decode_validation::none);
+  BOOST_TEST(status[2] == boost::radix::decode_validation::none);
+  BOOST_TEST(
+      status[3] == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(status[4] == boost::radix::decode_validation::none);
+  BOOST_TEST(status[5] == boost::radix::decode_validation::invalid_whitespace);
+  BOOST_TEST(status[6] == boost::radix::decode_validation::none);
+}
@@ -328,3 +328,108 @@ BOOST_AUTO_TEST_CASE(static_iobitstream_msb) {
     check_static_iostream_msb<7>(segments[i]);
   }
 }
+
+// The segment at a time code that the fast paths must agree with.
+template <std::size_t Bits>
+struct unpack_ladder_msb {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    boost::radix::detail::unpack(
+        packed, u, boost::integral_constant<std::size_t, Bits>());
+  }
+};
+
+template <std::size_t Bits>
+struct unpack_basic_lsb {
+  template <typename UnpackedSegment>
+  void operator()(bits_type const* packed, UnpackedSegment& u) const {
+    boost::radix::detail::unpack_lsb_basic<Bits>(packed, u);
+  }
+};
+
+// Runs of segments go through the vector streams, and single segments in
+// memory through pdep and pext, where they are available. Check every run
+// length around the block sizes against the scalar code, from unaligned
+// memory.
+template <
+    std::size_t Bits,
+    typename ScalarUnpacker,
+    typename SegmentUnpacker,
+    typename SegmentPacker>
+static void check_segment_runs(
+    ScalarUnpacker scalar,
+    SegmentUnpacker segment_unpacker,
+    SegmentPacker segment_packer) {
+  std::size_t const packed_segment_size =
+      boost::radix::bits::to_packed_segment_size<Bits>::value;
+  std::size_t const unpacked_segment_size =
+      boost::radix::bits::to_unpacked_segment_size<Bits>::value;
+
+  for(std::size_t segments = 0; segments < 40; ++segments) {
+    std::vector<bits_type> packed =
+        generate_random_bytes(segments * packed_segment_size + 1);
+    bits_type const* packed_first = packed.data() + 1;
+
+    std::vector<bits_type> expected(segments * unpacked_segment_size);
+    for(std::size_t i = 0; i < segments; ++i) {
+      boost::array<bits_type, unpacked_segment_size> segment;
+      scalar(packed_first + i * packed_segment_size, segment);
+      std::copy(
+          segment.begin(), segment.end(),
+          expected.begin() + i * unpacked_segment_size);
+    }
+
+    std::vector<bits_type> unpacked(expected.size() + 1, 0xEE);
+    boost::radix::detail::unpack_segments<
+        packed_segment_size, unpacked_segment_size>(
+        segment_unpacker, packed_first, segments, unpacked.data());
+    BOOST_TEST(
+        std::vector<bits_type>(unpacked.begin(), unpacked.end() - 1) ==
+        expected);
+    BOOST_TEST(unpacked.back() == 0xEE);
+
+    std::vector<bits_type> repacked(packed.size(), 0xEE);
+    bits_type* repacked_last = boost::radix::detail::pack_segments<
+        packed_segment_size, unpacked_segment_size>(
+        segment_packer, unpacked.data(), segments, repacked.data());
+    BOOST_TEST(repacked_last == repacked.data() + packed.size() - 1);
+    BOOST_TEST(
+        std::vector<bits_type>(repacked.begin(), repacked.end() - 1) ==
+        std::vector<bits_type>(packed.begin() + 1, packed.end()));
+    BOOST_TEST(repacked.back() == 0xEE);
+  }
+}
+
+template <std::size_t Bits>
+static void check_segment_runs_msb() {
+  check_segment_runs<Bits>(
+      unpack_ladder_msb<Bits>(), boost::radix::static_ibitstream_msb<Bits>(),
+      boost::radix::static_obitstream_msb<Bits>());
+}
+
+template <std::size_t Bits>
+static void check_segment_runs_lsb() {
+  check_segment_runs<Bits>(
+      unpack_basic_lsb<Bits>(), boost::radix::static_ibitstream_lsb<Bits>(),
+      boost::radix::static_obitstream_lsb<Bits>());
+}
+
+BOOST_AUTO_TEST_CASE(segment_runs_msb) {
+  check_segment_runs_msb<1>();
+  check_segment_runs_msb<2>();
+  check_segment_runs_msb<3>();
+  check_segment_runs_msb<4>();
+  check_segment_runs_msb<5>();
+  check_segment_runs_msb<6>();
+  check_segment_runs_msb<7>();
+}
+
+BOOST_AUTO_TEST_CASE(segment_runs_lsb) {
+  check_segment_runs_lsb<1>();
+  check_segment_runs_lsb<2>();
+  check_segment_runs_lsb<3>();
+  check_segment_runs_lsb<4>();
+  check_segment_runs_lsb<5>();
+  check_segment_runs_lsb<6>();
+  check_segment_runs_lsb<7>();
+}
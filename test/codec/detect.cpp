@@ -0,0 +1,113 @@
+//
+// test/codec/detect.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestDetect
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/detect.hpp>
+#include <boost/radix/encode.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "../common.hpp"
+
+using namespace boost::radix::codec::rfc4648;
+
+// -----------------------------------------------------------------------------
+// Contiguous input is classified a block at a time and a std::list one
+// character at a time, so every case checks that both agree.
+detection_result detect_string(std::string const& input) {
+  detection_result contiguous =
+      detect(input.data(), input.data() + input.size());
+
+  std::list<char_type> listed(input.begin(), input.end());
+  detection_result scalar = detect(listed.begin(), listed.end());
+  BOOST_TEST(scalar.size() == contiguous.size());
+  for(std::size_t i = 0; i < scalar.size() && i < contiguous.size(); ++i) {
+    BOOST_TEST(scalar[i].codec == contiguous[i].codec);
+    BOOST_TEST(scalar[i].fit == contiguous[i].fit);
+  }
+  return contiguous;
+}
+
+template <typename Codec>
+std::string encode_random(std::size_t size, Codec const& codec) {
+  std::vector<bits_type> data = generate_random_bytes(size);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+  return encoded;
+}
+
+BOOST_AUTO_TEST_CASE(detect_hex) {
+  detection_result result = detect_string("DEADBEEF0123456789");
+  BOOST_TEST(result.size() == 4u);
+  BOOST_TEST(result[0].codec == encoding_base16);
+  BOOST_TEST(result[1].codec == encoding_base32hex);
+  BOOST_TEST(result[0].fit == length_fit_whole_segments);
+  BOOST_TEST(!result.contains(encoding_base32));
+
+  // Odd length hex can't be base16, but is still in its alphabet.
+  result = detect_string("ABC");
+  BOOST_TEST(result.contains(encoding_base16));
+  BOOST_TEST(result[0].codec != encoding_base16);
+}
+
+BOOST_AUTO_TEST_CASE(detect_encoded) {
+  for(std::size_t size = 40; size < 2000; size += 97) {
+    detection_result result = detect_string(encode_random(size, base16()));
+    BOOST_TEST(result[0].codec == encoding_base16);
+
+    result = detect_string(encode_random(size, base32()));
+    BOOST_TEST(result[0].codec == encoding_base32);
+    BOOST_TEST(!result.contains(encoding_base16));
+
+    result = detect_string(encode_random(size, base32hex()));
+    BOOST_TEST(result[0].codec == encoding_base32hex);
+    BOOST_TEST(!result.contains(encoding_base32));
+
+    // Long enough random base64 uses both of its last two symbols.
+    std::string encoded = encode_random(size, base64());
+    result = detect_string(encoded);
+    BOOST_TEST(result.size() == 1u);
+    BOOST_TEST(result[0].codec == encoding_base64);
+    BOOST_TEST(result[0].fit == length_fit_whole_segments);
+
+    result = detect_string(encode_random(size, base64url()));
+    BOOST_TEST(result.size() == 1u);
+    BOOST_TEST(result[0].codec == encoding_base64url);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(detect_padding) {
+  detection_result result = detect_string("Zm9vYg==");
+  BOOST_TEST(result[0].codec == encoding_base64);
+  BOOST_TEST(result[0].fit == length_fit_whole_segments);
+
+  result = detect_string("Zm9vYg");
+  BOOST_TEST(result[0].fit == length_fit_partial_segment);
+
+  result = detect_string("Zm9vY===");
+  BOOST_TEST(result[0].fit == length_fit_none);
+
+  // Pads anywhere but the end rule out every encoding.
+  BOOST_TEST(detect_string("Zm9v=mFy").empty());
+
+  std::string long_input = encode_random(300, base64()) + "==";
+  BOOST_TEST(!detect_string(long_input).empty());
+  long_input[100] = '=';
+  BOOST_TEST(detect_string(long_input).empty());
+}
+
+BOOST_AUTO_TEST_CASE(detect_nothing) {
+  BOOST_TEST(detect_string("not base64!").empty());
+  BOOST_TEST(detect_string(std::string(100, ' ') + "AAAA").empty());
+  BOOST_TEST(detect_string("").size() == 5u);
+}
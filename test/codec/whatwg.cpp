@@ -0,0 +1,130 @@
+//
+// test/codec/whatwg.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestWhatwg
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/codec/whatwg/forgiving_base64.hpp>
+#include <boost/radix/encode.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "../common.hpp"
+
+// -----------------------------------------------------------------------------
+//
+boost::radix::decode_result
+forgiving_decode_string(std::string const& input, std::string& output) {
+  output.resize(input.size());
+  boost::radix::decode_result result =
+      boost::radix::codec::whatwg::forgiving_decode(
+          input.begin(), input.end(), output.begin());
+  output.resize(result.bytes_written);
+  return result;
+}
+
+bool decodes_to(char const* input, char const* expected) {
+  std::string output;
+  boost::radix::decode_result result =
+      forgiving_decode_string(input, output);
+  return result.ok() && output == expected;
+}
+
+boost::radix::decode_validation::error decode_error(char const* input) {
+  std::string output;
+  return forgiving_decode_string(input, output).error;
+}
+
+// Cases from the web platform tests for atob.
+BOOST_AUTO_TEST_CASE(forgiving_base64_vectors) {
+  using namespace boost::radix::decode_validation;
+
+  BOOST_TEST(decodes_to("", ""));
+  BOOST_TEST(decodes_to("YQ", "a"));
+  BOOST_TEST(decodes_to("YR", "a"));
+  BOOST_TEST(decodes_to("YQ==", "a"));
+  BOOST_TEST(decodes_to("YWI", "ab"));
+  BOOST_TEST(decodes_to("YWI=", "ab"));
+  BOOST_TEST(decodes_to("YWJj", "abc"));
+  BOOST_TEST(decodes_to(" Y Q = = ", "a"));
+  BOOST_TEST(decodes_to("\tYW\nJj\f\r", "abc"));
+  BOOST_TEST(decodes_to("+/+/", "\xfb\xff\xbf"));
+  BOOST_TEST(decodes_to("-_-_", "\xfb\xff\xbf"));
+  BOOST_TEST(decodes_to("+_-/", "\xfb\xff\xbf"));
+
+  BOOST_TEST(decode_error("Y") == incomplete_segment);
+  BOOST_TEST(decode_error("YQ=") == invalid_padding);
+  BOOST_TEST(decode_error("YQ===") == nonalphabet_character);
+  BOOST_TEST(decode_error("YWJj=") == invalid_padding);
+  BOOST_TEST(decode_error("YQ==YQ==") == nonalphabet_character);
+  BOOST_TEST(decode_error("=") == invalid_padding);
+  BOOST_TEST(decode_error("====") == nonalphabet_character);
+  BOOST_TEST(decode_error("YQ\v") == nonalphabet_character);
+  BOOST_TEST(decode_error("Y*Q") == nonalphabet_character);
+}
+
+BOOST_AUTO_TEST_CASE(forgiving_base64_error_offset) {
+  std::string output;
+  boost::radix::decode_result result =
+      forgiving_decode_string("YWJj YW*J", output);
+  BOOST_TEST(result.error == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(result.error_offset == 7u);
+  BOOST_TEST(result.bytes_consumed == 0u);
+
+  result = forgiving_decode_string("YWJjYQ=\n", output);
+  BOOST_TEST(result.error == boost::radix::decode_validation::invalid_padding);
+  BOOST_TEST(result.error_offset == 6u);
+}
+
+// Mixed alphabets, missing padding and whitespace, long enough for the block
+// path when contiguous and checked again one character at a time.
+BOOST_AUTO_TEST_CASE(forgiving_base64_mixed) {
+  for(std::size_t size = 0; size < 5000; size += 293) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded),
+        boost::radix::codec::rfc4648::base64());
+
+    std::string mixed;
+    for(std::size_t i = 0; i < encoded.size(); ++i) {
+      char_type c = encoded[i];
+      if(i % 3 == 0 && c == '+')
+        c = '-';
+      else if(i % 2 == 0 && c == '/')
+        c = '_';
+      if(size % 2 && c == '=')
+        continue;
+      if(i && i % 64 == 0)
+        mixed += "\r\n";
+      else if(i % 29 == 0)
+        mixed += ' ';
+      mixed += c;
+    }
+    mixed += '\n';
+
+    std::vector<bits_type> contiguous(mixed.size());
+    boost::radix::decode_result result =
+        boost::radix::codec::whatwg::forgiving_decode(
+            mixed.data(), mixed.data() + mixed.size(), contiguous.data());
+    BOOST_TEST(result.ok());
+    BOOST_TEST(result.bytes_consumed == mixed.size());
+    contiguous.resize(result.bytes_written);
+    BOOST_TEST(contiguous == data);
+
+    std::list<char_type> listed(mixed.begin(), mixed.end());
+    std::vector<bits_type> scalar;
+    result = boost::radix::codec::whatwg::forgiving_decode(
+        listed.begin(), listed.end(), std::back_inserter(scalar));
+    BOOST_TEST(result.ok());
+    BOOST_TEST(scalar == data);
+  }
+}
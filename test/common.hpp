@@ -16,6 +16,7 @@
 #include <boost/cstdint.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
+#include <list>
 #include <vector>
 
 typedef boost::radix::bits_type bits_type;
@@ -187,4 +188,16 @@ struct is_equal_unsigned {
   }
 };
 
+// Calls check(first, last) on input in contiguous memory and then on a
+// std::list copy of it. Contiguous input takes the block at a time paths and
+// the list the one element at a time paths, so the same check covers both.
+template <typename Container, typename Check>
+void check_contiguous_and_listed(Container const& input, Check check) {
+  typedef typename Container::value_type value_type;
+  value_type const* data = input.data();
+  check(data, data + input.size());
+  std::list<value_type> const listed(input.begin(), input.end());
+  check(listed.begin(), listed.end());
+}
+
 #endif // BOOST_RADIX_TEST_GENERATE_BYTES_HPP
@@ -11,9 +11,11 @@
 #include <boost/test/unit_test.hpp>
 
 #include <boost/radix/basic_codec.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
 #include <boost/radix/decode.hpp>
 #include <boost/radix/static_obitstream_lsb.hpp>
 #include <boost/range/algorithm/equal.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <vector>
 
@@ -98,7 +100,7 @@ void test_decoder(DataGenerator data_generator, Encoder codec) {
   std::vector<char_type> alphabet = generate_alphabet(Bits);
   std::vector<bits_type> data     = data_generator(Bits);
   std::vector<bits_type> result;
-  result.resize(boost::radix::decoded_size(data.size(), codec));
+  result.resize(boost::radix::decoded_size(alphabet.size(), codec));
   boost::radix::decoder<Encoder, bits_type*> decoder =
       boost::radix::make_decoder(codec, result.data());
   decoder.append(alphabet.begin(), alphabet.end());
@@ -107,6 +109,35 @@ void test_decoder(DataGenerator data_generator, Encoder codec) {
   BOOST_TEST(boost::equal(data, result, is_equal_unsigned()));
 }
 
+template <std::size_t Bits, typename Encoder>
+void test_decode_buffers(Encoder codec) {
+  std::vector<char_type> alphabet = generate_alphabet(Bits);
+
+  // Decode the alphabet a number of times over so that the fragments below
+  // straddle segment boundaries at every possible offset.
+  std::vector<char_type> encoded;
+  for(int i = 0; i < 16; ++i) {
+    encoded.insert(encoded.end(), alphabet.begin(), alphabet.end());
+  }
+
+  std::vector<bits_type> expected;
+  boost::radix::decode(
+      encoded.begin(), encoded.end(), std::back_inserter(expected), codec);
+
+  std::vector<boost::iterator_range<char_type const*> > buffers;
+  char_type const* in  = encoded.data();
+  char_type const* end = in + encoded.size();
+  for(std::size_t size = 0; in != end; size = (size + 1) % 11) {
+    std::size_t fragment = std::min<std::size_t>(size, end - in);
+    buffers.push_back(boost::make_iterator_range(in, in + fragment));
+    in += fragment;
+  }
+
+  std::vector<bits_type> result;
+  boost::radix::decode_buffers(buffers, std::back_inserter(result), codec);
+  BOOST_TEST(boost::equal(expected, result, is_equal_unsigned()));
+}
+
 // -----------------------------------------------------------------------------
 //
 BOOST_AUTO_TEST_CASE(decode_one_bit_msb) {
@@ -192,3 +223,72 @@ BOOST_AUTO_TEST_CASE(decoder_six_bit_msb) {
 BOOST_AUTO_TEST_CASE(decoder_seven_bit_msb) {
   test_decoder<7>(generate_all_permutations_msb, msb_codec<7>());
 }
+
+BOOST_AUTO_TEST_CASE(decode_buffers_one_bit_msb) {
+  test_decode_buffers<1>(msb_codec<1>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_two_bit_msb) {
+  test_decode_buffers<2>(msb_codec<2>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_three_bit_msb) {
+  test_decode_buffers<3>(msb_codec<3>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_four_bit_msb) {
+  test_decode_buffers<4>(msb_codec<4>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_five_bit_msb) {
+  test_decode_buffers<5>(msb_codec<5>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_six_bit_msb) {
+  test_decode_buffers<6>(msb_codec<6>());
+}
+
+BOOST_AUTO_TEST_CASE(decode_buffers_seven_bit_msb) {
+  test_decode_buffers<7>(msb_codec<7>());
+}
+
+// -----------------------------------------------------------------------------
+// The decoder peeks at the character after a full segment to see whether the
+// segment is the last one, and must not report that character twice.
+struct counting_error_handler {
+  template <typename Codec>
+  counting_error_handler(Codec const&)
+      : calls(0) {
+  }
+
+  template <typename Codec>
+  boost::radix::decode_validation::op
+  handle_whitespace_character(Codec const&, boost::radix::char_type) {
+    ++calls;
+    return boost::radix::decode_validation::op_skip;
+  }
+
+  template <typename Codec>
+  boost::radix::decode_validation::op
+  handle_nonalphabet_character(Codec const&, boost::radix::char_type) {
+    ++calls;
+    return boost::radix::decode_validation::op_consume;
+  }
+
+  int calls;
+};
+
+BOOST_AUTO_TEST_CASE(decode_handles_each_character_once) {
+  boost::radix::codec::rfc4648::base64 codec;
+  counting_error_handler errh(codec);
+  std::string const input = "Zm9v*m9v";
+  std::vector<bits_type> result;
+  boost::radix::decoder<
+      boost::radix::codec::rfc4648::base64,
+      std::back_insert_iterator<std::vector<bits_type> > >
+      d(codec, std::back_inserter(result));
+  d.append(input.begin(), input.end(), errh);
+  d.resolve();
+  BOOST_TEST(errh.calls == 1);
+  BOOST_TEST(result.size() == 6u);
+}
@@ -0,0 +1,178 @@
+//
+// test/decode_errors.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestDecodeErrors
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/basic_codec.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+//
+#if BOOST_RADIX_SUPPORT_BOOSTERRORCODE
+BOOST_AUTO_TEST_CASE(decode_boost_error_code) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string encoded = "Zm9v*mFy";
+  std::vector<bits_type> result;
+  boost::system::error_code errc;
+  boost::radix::decode(
+      encoded.begin(), encoded.end(), std::back_inserter(result), codec, errc);
+  BOOST_TEST(errc == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(std::string(errc.category().name()) == "boost.radix.decode");
+  BOOST_TEST(result.size() == 3u);
+}
+#endif
+
+#if BOOST_RADIX_SUPPORT_STDERRORCODE
+BOOST_AUTO_TEST_CASE(decode_std_error_code) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string encoded = "Zm9v\nmFy";
+  std::vector<bits_type> result;
+  std::error_code errc;
+  boost::radix::decode(
+      encoded.begin(), encoded.end(), std::back_inserter(result), codec, errc);
+  BOOST_TEST(errc == boost::radix::decode_validation::invalid_whitespace);
+  BOOST_TEST(!errc.message().empty());
+  BOOST_TEST(result.size() == 3u);
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Contiguous input takes the block path while a std::list is decoded one
+// character at a time.
+template <typename Codec>
+struct check_try_decode_result {
+  check_try_decode_result(
+      Codec const& codec,
+      std::vector<bits_type> const& expected,
+      std::size_t bytes_consumed,
+      boost::radix::decode_validation::error error,
+      std::size_t error_offset)
+      : codec_(&codec)
+      , expected_(&expected)
+      , bytes_consumed_(bytes_consumed)
+      , error_(error)
+      , error_offset_(error_offset) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::vector<bits_type> decoded(
+        boost::radix::decoded_size(std::distance(first, last), *codec_));
+    boost::radix::decode_result result =
+        boost::radix::try_decode(first, last, decoded.data(), *codec_);
+    BOOST_TEST(result.error == error_);
+    BOOST_TEST(result.error_offset == error_offset_);
+    BOOST_TEST(result.bytes_consumed == bytes_consumed_);
+    BOOST_TEST(result.bytes_written == expected_->size());
+    decoded.resize(result.bytes_written);
+    BOOST_TEST(decoded == *expected_);
+  }
+
+  Codec const* codec_;
+  std::vector<bits_type> const* expected_;
+  std::size_t bytes_consumed_;
+  boost::radix::decode_validation::error error_;
+  std::size_t error_offset_;
+};
+
+template <typename Codec>
+void check_try_decode(
+    std::string const& encoded,
+    std::vector<bits_type> const& data,
+    Codec const& codec,
+    boost::radix::decode_validation::error error,
+    std::size_t error_offset) {
+  std::size_t const packed = boost::radix::codec_traits::packed_segment_size<
+      Codec>::value;
+  std::size_t const unpacked = boost::radix::codec_traits::
+      unpacked_segment_size<Codec>::value;
+
+  std::size_t bytes_consumed = encoded.size();
+  std::size_t bytes_written  = data.size();
+  if(error != boost::radix::decode_validation::none) {
+    bytes_consumed = error_offset / unpacked * unpacked;
+    bytes_written  = error_offset / unpacked * packed;
+  }
+
+  std::vector<bits_type> const expected(
+      data.begin(), data.begin() + bytes_written);
+  check_contiguous_and_listed(
+      encoded, check_try_decode_result<Codec>(
+                   codec, expected, bytes_consumed, error, error_offset));
+}
+
+template <typename Codec>
+void test_try_decode(Codec const& codec) {
+  for(std::size_t size = 0; size < 3000; size += 173) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec);
+    check_try_decode(
+        encoded, data, codec, boost::radix::decode_validation::none,
+        encoded.size());
+
+    if(encoded.empty())
+      continue;
+
+    std::size_t const bad_offset = (size * 13) % encoded.size();
+    std::string bad              = encoded;
+    bad[bad_offset]              = '#';
+    check_try_decode(
+        bad, data, codec, boost::radix::decode_validation::nonalphabet_character,
+        bad_offset);
+
+    bad[bad_offset] = ' ';
+    check_try_decode(
+        bad, data, codec, boost::radix::decode_validation::invalid_whitespace,
+        bad_offset);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(try_decode_base64) {
+  test_try_decode(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(try_decode_base32) {
+  test_try_decode(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(try_decode_base2) {
+  test_try_decode(boost::radix::basic_codec<2>("01"));
+}
+
+// The held back final segment is resolved, not written with its padding,
+// when the error comes after it.
+BOOST_AUTO_TEST_CASE(try_decode_error_after_padding) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string const foof = "foof";
+  std::vector<bits_type> const expected(foof.begin(), foof.end());
+  check_contiguous_and_listed(
+      std::string("Zm9vZg==!"),
+      check_try_decode_result<boost::radix::codec::rfc4648::base64>(
+          codec, expected, 8,
+          boost::radix::decode_validation::nonalphabet_character, 8));
+}
+
+#ifndef BOOST_NO_CXX11_NOEXCEPT
+BOOST_AUTO_TEST_CASE(try_decode_noexcept) {
+  boost::radix::codec::rfc4648::base64 codec;
+  char_type const* in = 0;
+  bits_type* out      = 0;
+  BOOST_TEST(noexcept(boost::radix::try_decode(in, in, out, codec)));
+}
+#endif
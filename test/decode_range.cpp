@@ -0,0 +1,146 @@
+//
+// test/decode_range.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestDecodeRange
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/decode_range.hpp>
+#include <boost/radix/encode.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Ranges are checked against the bytes originally encoded, including ranges
+// at either end, ranges that run past the end and empty ones.
+template <typename Decoder>
+void check_ranges(std::vector<bits_type> const& data, Decoder decode) {
+  std::size_t const size = data.size();
+  std::size_t const bounds[][2] = {
+      {0, 0},        {0, 1},           {0, 1024},        {1, 2},
+      {2, 7},        {5, 5000},        {4095, 4097},     {12345, 20000},
+      {size - 1, size}, {size - 3, size + 10}, {0, size}, {size, size + 5},
+      {size + 3, size + 5}};
+
+  for(std::size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); ++i) {
+    std::size_t const byte_first = bounds[i][0];
+    std::size_t const byte_last  = bounds[i][1];
+    std::vector<bits_type> expected(
+        data.begin() + std::min(byte_first, size),
+        data.begin() + std::min(byte_last, size));
+    std::vector<bits_type> decoded;
+    std::size_t written =
+        decode(byte_first, byte_last, std::back_inserter(decoded));
+    BOOST_TEST(written == expected.size());
+    BOOST_TEST(decoded == expected);
+  }
+}
+
+template <typename Codec>
+struct unwrapped_decoder {
+  unwrapped_decoder(std::string const& text, Codec const& codec)
+      : text_(text)
+      , codec_(codec) {
+  }
+
+  template <typename OutputIterator>
+  std::size_t operator()(
+      std::size_t byte_first, std::size_t byte_last, OutputIterator out) const {
+    return boost::radix::decode_range(
+        text_.data(), text_.data() + text_.size(), byte_first, byte_last, out,
+        codec_);
+  }
+
+  std::string const& text_;
+  Codec const& codec_;
+};
+
+template <typename Codec, typename Lines>
+struct wrapped_decoder {
+  wrapped_decoder(std::string const& text, Codec const& codec, Lines lines)
+      : text_(text)
+      , codec_(codec)
+      , lines_(lines) {
+  }
+
+  template <typename OutputIterator>
+  std::size_t operator()(
+      std::size_t byte_first, std::size_t byte_last, OutputIterator out) const {
+    return boost::radix::decode_range(
+        text_.begin(), text_.end(), byte_first, byte_last, out, codec_,
+        lines_);
+  }
+
+  std::string const& text_;
+  Codec const& codec_;
+  Lines lines_;
+};
+
+template <typename Codec>
+void test_decode_range(Codec const& codec) {
+  for(std::size_t size = 30000; size < 30004; ++size) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+
+    std::string text;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(text), codec);
+    check_ranges(data, unwrapped_decoder<Codec>(text, codec));
+
+    boost::radix::line_wrapping const mime =
+        boost::radix::line_wrapping::mime();
+    std::string wrapped;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(wrapped), codec, mime);
+    check_ranges(
+        data, wrapped_decoder<Codec, boost::radix::line_wrapping>(
+                  wrapped, codec, mime));
+    check_ranges(
+        data, wrapped_decoder<Codec, boost::radix::line_index>(
+                  wrapped, codec,
+                  boost::radix::line_index(wrapped.begin(), wrapped.end())));
+
+    // Lines of varying length, some blank and some ending in "\r\n".
+    std::string ragged;
+    for(std::size_t i = 0, line = 1; i < text.size(); line = line % 97 + 1) {
+      std::size_t count = std::min(line, text.size() - i);
+      ragged.append(text, i, count);
+      ragged += line % 3 ? "\n" : "\r\n";
+      if(line % 17 == 0)
+        ragged += "\n";
+      i += count;
+    }
+    check_ranges(
+        data, wrapped_decoder<Codec, boost::radix::line_index>(
+                  ragged, codec,
+                  boost::radix::line_index(ragged.begin(), ragged.end())));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(decode_range_base32) {
+  test_decode_range(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(decode_range_base64) {
+  test_decode_range(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(line_index_runs) {
+  std::string const text = "abcd\r\nefgh\r\nij\n\nklmno\npq";
+  boost::radix::line_index index(text.begin(), text.end());
+  BOOST_TEST(index.symbols() == 17u);
+  BOOST_TEST(index.position(0) == 0u);
+  BOOST_TEST(index.position(4) == 6u);
+  BOOST_TEST(index.position(9) == 13u);
+  BOOST_TEST(index.position(10) == 16u);
+  BOOST_TEST(index.position(15) == 22u);
+  BOOST_TEST(index.position(17) == text.size());
+}
@@ -0,0 +1,186 @@
+//
+// test/decode_sink.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestDecodeSink
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/crc32c.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/decode_sink.hpp>
+#include <boost/radix/encode.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Collects the chunks through a pointer, as the sink is copied.
+struct chunk_collector {
+  explicit chunk_collector(std::vector<std::vector<bits_type> >& chunks)
+      : chunks_(&chunks) {
+  }
+
+  void operator()(bits_type const* data, std::size_t size) const {
+    BOOST_TEST(size != 0u);
+    BOOST_TEST(size <= boost::radix::detail::decode_sink_buffer_size);
+    chunks_->push_back(std::vector<bits_type>(data, data + size));
+  }
+
+  std::vector<std::vector<bits_type> >* chunks_;
+};
+
+std::vector<bits_type>
+join(std::vector<std::vector<bits_type> > const& chunks) {
+  std::vector<bits_type> joined;
+  for(std::size_t i = 0; i < chunks.size(); ++i)
+    joined.insert(joined.end(), chunks[i].begin(), chunks[i].end());
+  return joined;
+}
+
+// Contiguous input is decoded a chunk at a time in place while a std::list is
+// copied out first, and both must produce the same chunks.
+template <typename Codec>
+struct check_decode_to_sink {
+  check_decode_to_sink(Codec const& codec, std::vector<bits_type> const& data)
+      : codec_(&codec)
+      , data_(&data) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::vector<std::vector<bits_type> > chunks;
+    std::size_t written = boost::radix::decode_to_sink(
+        first, last, chunk_collector(chunks), *codec_);
+    BOOST_TEST(written == data_->size());
+    BOOST_TEST(join(chunks) == *data_);
+    BOOST_TEST(chunks.size() <= data_->size() / 4000 + 2);
+  }
+
+  Codec const* codec_;
+  std::vector<bits_type> const* data_;
+};
+
+// As above, but with an aborting handler, so decoding must stop at the error
+// with expected passed on.
+template <typename Codec>
+struct check_decode_to_sink_error {
+  check_decode_to_sink_error(
+      Codec const& codec, std::vector<bits_type> const& expected)
+      : codec_(&codec)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    boost::radix::decode_validation::error error =
+        boost::radix::decode_validation::none;
+    boost::radix::decode_error_handler_error_code<
+        boost::radix::decode_validation::error>
+        errh(*codec_, error);
+    std::vector<std::vector<bits_type> > chunks;
+    std::size_t written = boost::radix::decode_to_sink(
+        first, last, chunk_collector(chunks), *codec_, errh);
+    BOOST_TEST(error == boost::radix::decode_validation::nonalphabet_character);
+    BOOST_TEST(written == expected_->size());
+    BOOST_TEST(join(chunks) == *expected_);
+  }
+
+  Codec const* codec_;
+  std::vector<bits_type> const* expected_;
+};
+
+template <typename Codec>
+void test_decode_to_sink(Codec const& codec) {
+  for(std::size_t size = 0; size < 30000; size += 4099) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+    check_contiguous_and_listed(
+        encoded, check_decode_to_sink<Codec>(codec, data));
+
+    std::string wrapped;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(wrapped), codec,
+        boost::radix::line_wrapping::mime());
+    boost::radix::decode_error_handler_skip_whitespace errh(codec);
+    boost::radix::crc32c crc;
+    std::size_t written = boost::radix::decode_to_sink(
+        wrapped.begin(), wrapped.end(), boost::radix::make_accumulator_sink(crc),
+        codec, errh);
+    boost::radix::crc32c expected;
+    expected.process_bytes(data.data(), data.size());
+    BOOST_TEST(written == data.size());
+    BOOST_TEST(crc.checksum() == expected.checksum());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(decode_to_sink_base32) {
+  test_decode_to_sink(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(decode_to_sink_base64) {
+  test_decode_to_sink(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(sink_decoder_errors) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string const bad = "Zm9v*mFy";
+  std::vector<std::vector<bits_type> > chunks;
+  BOOST_CHECK_THROW(
+      boost::radix::decode_to_sink(
+          bad.begin(), bad.end(), chunk_collector(chunks), codec),
+      boost::radix::nonalphabet_character);
+
+  // Appended piecewise, segments split across appends come out whole.
+  boost::radix::sink_decoder<boost::radix::codec::rfc4648::base64,
+                             chunk_collector>
+      d(codec, chunk_collector(chunks));
+  std::string const text = "Zm9vYmFyYmF6";
+  chunks.clear();
+  for(std::size_t i = 0; i < text.size(); ++i)
+    d.append(text.begin() + i, text.begin() + i + 1);
+  d.resolve();
+  std::vector<bits_type> joined = join(chunks);
+  BOOST_TEST(std::string(joined.begin(), joined.end()) == "foobarbaz");
+  BOOST_TEST(d.bytes_written() == 9u);
+}
+
+// An aborting handler stops decoding at the error, in any chunk, rather than
+// carrying on past it.
+BOOST_AUTO_TEST_CASE(sink_decoder_error_code) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(30000);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+  std::size_t const offsets[] = {100, 102, 6000, 39000};
+  for(std::size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+    std::string bad = encoded;
+    bad[offsets[i]] = '*';
+    std::vector<bits_type> const expected(
+        data.begin(), data.begin() + offsets[i] / 4 * 3);
+    check_contiguous_and_listed(
+        bad, check_decode_to_sink_error<boost::radix::codec::rfc4648::base64>(
+                 codec, expected));
+  }
+
+  // The final segment is resolved, not passed on with its padding, when the
+  // error comes straight after it.
+  std::string const foof = "foof";
+  std::vector<bits_type> const expected(foof.begin(), foof.end());
+  check_contiguous_and_listed(
+      std::string("Zm9vZg==!"),
+      check_decode_to_sink_error<boost::radix::codec::rfc4648::base64>(
+          codec, expected));
+}
@@ -0,0 +1,166 @@
+//
+// test/decode_whitespace.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestDecodeWhitespace
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/range/algorithm/equal.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+//
+template <typename Codec>
+std::string make_wrapped(std::vector<bits_type> const& data, Codec const& codec) {
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+  std::string wrapped;
+  for(std::size_t i = 0; i < encoded.size(); ++i) {
+    if(i && i % 76 == 0)
+      wrapped += "\r\n";
+    else if(i % 53 == 0)
+      wrapped += ' ';
+    wrapped += encoded[i];
+  }
+  wrapped += "\r\n";
+  return wrapped;
+}
+
+template <typename Codec>
+struct check_decode_wrapped {
+  check_decode_wrapped(Codec const& codec, std::vector<bits_type> const& data)
+      : codec_(&codec)
+      , data_(&data) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    boost::radix::decode_error_handler_skip_whitespace errh(*codec_);
+    std::vector<bits_type> result;
+    boost::radix::decode(
+        first, last, std::back_inserter(result), *codec_, errh);
+    BOOST_TEST(result == *data_);
+    BOOST_TEST(
+        boost::radix::count_decoded_bytes(first, last, *codec_) ==
+        data_->size());
+  }
+
+  Codec const* codec_;
+  std::vector<bits_type> const* data_;
+};
+
+template <typename Codec>
+void test_decode_skip_whitespace(Codec const& codec, std::size_t size) {
+  std::vector<bits_type> data = generate_random_bytes(size);
+  check_contiguous_and_listed(
+      make_wrapped(data, codec), check_decode_wrapped<Codec>(codec, data));
+}
+
+BOOST_AUTO_TEST_CASE(decode_skip_whitespace_base64) {
+  boost::radix::codec::rfc4648::base64 codec;
+  for(std::size_t size = 0; size < 4000; size += 331)
+    test_decode_skip_whitespace(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(decode_skip_whitespace_base32) {
+  boost::radix::codec::rfc4648::base32 codec;
+  for(std::size_t size = 0; size < 4000; size += 331)
+    test_decode_skip_whitespace(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(decode_without_whitespace) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3001);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+  std::vector<bits_type> result;
+  boost::radix::decode(
+      encoded.data(), encoded.data() + encoded.size(),
+      std::back_inserter(result), codec);
+  BOOST_TEST(result == data);
+}
+
+// Exact sizes for a single allocation, with and without the padding.
+template <typename Codec>
+void test_count_decoded_bytes(Codec const& codec) {
+  for(std::size_t size = 0; size < 1500; size += 47) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec);
+    std::string unpadded =
+        encoded.substr(0, encoded.find(codec.get_pad_char()));
+
+    BOOST_TEST(
+        boost::radix::count_decoded_bytes(
+            encoded.data(), encoded.data() + encoded.size(), codec) ==
+        data.size());
+    BOOST_TEST(
+        boost::radix::count_decoded_bytes(
+            unpadded.data(), unpadded.data() + unpadded.size(), codec) ==
+        data.size());
+    BOOST_TEST(
+        boost::radix::count_decoded_bytes(
+            unpadded.begin(), unpadded.end(), codec) == data.size());
+
+    std::vector<bits_type> result(boost::radix::count_decoded_bytes(
+        unpadded.data(), unpadded.data() + unpadded.size(), codec));
+    boost::radix::decode(
+        unpadded.begin(), unpadded.end(), result.begin(), codec);
+    BOOST_TEST(result == data);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(count_decoded_bytes_base64) {
+  test_count_decoded_bytes(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(count_decoded_bytes_base32) {
+  test_count_decoded_bytes(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(decode_whitespace_errors) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string wrapped         = make_wrapped(data, codec);
+  std::vector<bits_type> result;
+
+  // Whitespace is still an error for the default handler.
+  BOOST_CHECK_THROW(
+      boost::radix::decode(
+          wrapped.data(), wrapped.data() + wrapped.size(),
+          std::back_inserter(result), codec),
+      boost::radix::invalid_whitespace);
+
+  // Characters outside the alphabet are caught mid block, and the data
+  // before them is still written.
+  wrapped[2000] = '*';
+  result.clear();
+  boost::radix::decode_error_handler_skip_whitespace errh(codec);
+  BOOST_CHECK_THROW(
+      boost::radix::decode(
+          wrapped.data(), wrapped.data() + wrapped.size(),
+          std::back_inserter(result), codec, errh),
+      boost::radix::nonalphabet_character);
+  BOOST_TEST(result.size() >= 1400u);
+  BOOST_TEST(boost::equal(
+      result, boost::make_iterator_range(
+                  data.begin(), data.begin() + result.size())));
+}
@@ -12,10 +12,12 @@
 
 #include <boost/foreach.hpp>
 #include <boost/radix/basic_codec.hpp>
+#include <boost/radix/buffer_sequence.hpp>
 #include <boost/radix/encode.hpp>
 #include <boost/radix/encode_iterator.hpp>
 #include <boost/radix/static_ibitstream_lsb.hpp>
 #include <boost/radix/static_ibitstream_msb.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <vector>
 
 #include "common.hpp"
@@ -152,6 +154,90 @@ void test_encode_part_single(Encoder codec) {
   BOOST_TEST(full_result == partial_result);
 }
 
+template <std::size_t Bits, typename Encoder>
+void test_encode_buffers(Encoder codec) {
+  std::vector<bits_type> data = generate_random_bytes(1024, (1 << Bits) - 1);
+  std::vector<char_type> full_result;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(full_result), codec);
+
+  // Split the input into fragments of varying size so that segments straddle
+  // the fragment boundaries at every possible offset.
+  std::vector<std::vector<bits_type> > buffers;
+  std::vector<bits_type>::iterator it = data.begin();
+  for(std::size_t size = 0; it != data.end(); size = (size + 1) % 13) {
+    std::size_t remaining = std::distance(it, data.end());
+    std::size_t fragment  = std::min(size, remaining);
+    buffers.push_back(std::vector<bits_type>(it, it + fragment));
+    it += fragment;
+  }
+
+  std::vector<char_type> gathered_result;
+  boost::radix::encode_buffers(
+      buffers, std::back_inserter(gathered_result), codec);
+  BOOST_TEST(full_result == gathered_result);
+
+  // Scatter the output across buffers too, including some empty ones.
+  std::vector<char_type> scattered_result(full_result.size());
+  std::vector<boost::iterator_range<char_type*> > output_buffers;
+  char_type* out = scattered_result.data();
+  char_type* end = out + scattered_result.size();
+  for(std::size_t size = 0; out != end; size = (size + 3) % 17) {
+    std::size_t fragment = std::min<std::size_t>(size, end - out);
+    output_buffers.push_back(boost::make_iterator_range(out, out + fragment));
+    out += fragment;
+  }
+
+  boost::radix::encode_buffers(
+      buffers, boost::radix::make_buffer_sequence_output_iterator(output_buffers),
+      codec);
+  BOOST_TEST(full_result == scattered_result);
+}
+
+template <std::size_t Bits, typename Encoder>
+void test_encode_line_wrapping(Encoder codec) {
+  std::vector<bits_type> data = generate_random_bytes(1000);
+  std::vector<char_type> unwrapped;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(unwrapped), codec);
+
+  // Line lengths both on and off a segment boundary.
+  std::size_t const line_lengths[] = {1, 24, 30, 64, 76};
+  boost::radix::line_terminator const terminators[] = {
+      boost::radix::line_terminator_lf, boost::radix::line_terminator_crlf};
+  BOOST_FOREACH(std::size_t line_length, line_lengths) {
+    BOOST_FOREACH(boost::radix::line_terminator terminator, terminators) {
+      boost::radix::line_wrapping wrapping(line_length, terminator);
+      std::vector<char_type> expected;
+      for(std::size_t i = 0; i < unwrapped.size(); ++i) {
+        if(i && i % line_length == 0)
+          wrapping.write_terminator(std::back_inserter(expected));
+        expected.push_back(unwrapped[i]);
+      }
+
+      std::vector<char_type> result(
+          boost::radix::encoded_size(data.size(), codec, wrapping));
+      std::size_t written = boost::radix::encode(
+          data.begin(), data.end(), result.data(), codec, wrapping);
+      BOOST_TEST(written == expected.size());
+      BOOST_TEST(result == expected);
+
+      // One byte at a time goes through the partial segment instead.
+      std::vector<char_type> single_result;
+      boost::radix::encoder<
+          Encoder, std::back_insert_iterator<std::vector<char_type> > >
+          encoder = boost::radix::make_encoder(
+              codec, std::back_inserter(single_result), wrapping);
+      BOOST_FOREACH(bits_type bits, data) {
+        encoder.append(bits);
+      }
+      encoder.resolve();
+      BOOST_TEST(encoder.bytes_written() == expected.size());
+      BOOST_TEST(single_result == expected);
+    }
+  }
+}
+
 template <std::size_t Bits, typename DataGenerator, typename Encoder>
 void test_encode_iterator(DataGenerator data_generator, Encoder encoder) {
   std::vector<char_type> alphabet = generate_alphabet(Bits);
@@ -164,6 +250,26 @@ void test_encode_iterator(DataGenerator data_generator, Encoder encoder) {
       alphabet.begin(), alphabet.end(), result.begin(), is_equal_unsigned()));
 }
 
+// Contiguous input to a 1 bit codec is turned straight into characters
+// rather than going through symbols, and should agree with the bits read
+// one at a time.
+template <typename Encoder, typename GetBits>
+void test_encode_contiguous_one_bit(Encoder codec, GetBits get_bits) {
+  std::vector<char_type> alphabet = generate_alphabet(1);
+  for(std::size_t size = 0; size < 200; size += 7) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string expected;
+    for(std::size_t i = 0; i < size * 8; ++i)
+      expected.push_back(alphabet[get_bits(data, i, 1)]);
+
+    std::string result;
+    boost::radix::encode(
+        data.data(), data.data() + data.size(), std::back_inserter(result),
+        codec);
+    BOOST_TEST(result == expected);
+  }
+}
+
 template <std::size_t Bits>
 void test_encode_msb() {
   test_encode<Bits>(generate_all_permutations_msb, msb_codec<Bits>());
@@ -230,6 +336,14 @@ BOOST_AUTO_TEST_CASE(encode_seven_bit_lsb) {
   test_encode_lsb<7>();
 }
 
+BOOST_AUTO_TEST_CASE(encode_contiguous_one_bit_msb) {
+  test_encode_contiguous_one_bit(msb_codec<1>(), get_bits_msb);
+}
+
+BOOST_AUTO_TEST_CASE(encode_contiguous_one_bit_lsb) {
+  test_encode_contiguous_one_bit(lsb_codec<1>(), get_bits_lsb);
+}
+
 BOOST_AUTO_TEST_CASE(encoder_one_bit_msb) {
   test_encoder<1>(generate_all_permutations_msb, msb_codec<1>());
 }
@@ -341,3 +455,93 @@ BOOST_AUTO_TEST_CASE(encode_part_range_six_bit_msb) {
 BOOST_AUTO_TEST_CASE(encode_part_range_seven_bit_msb) {
   test_encode_part_range<7>(msb_codec<7>());
 }
+
+BOOST_AUTO_TEST_CASE(encode_buffers_one_bit_msb) {
+  test_encode_buffers<1>(msb_codec<1>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_two_bit_msb) {
+  test_encode_buffers<2>(msb_codec<2>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_three_bit_msb) {
+  test_encode_buffers<3>(msb_codec<3>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_four_bit_msb) {
+  test_encode_buffers<4>(msb_codec<4>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_five_bit_msb) {
+  test_encode_buffers<5>(msb_codec<5>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_six_bit_msb) {
+  test_encode_buffers<6>(msb_codec<6>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_buffers_seven_bit_msb) {
+  test_encode_buffers<7>(msb_codec<7>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_one_bit_msb) {
+  test_encode_line_wrapping<1>(msb_codec<1>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_two_bit_msb) {
+  test_encode_line_wrapping<2>(msb_codec<2>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_three_bit_msb) {
+  test_encode_line_wrapping<3>(msb_codec<3>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_four_bit_msb) {
+  test_encode_line_wrapping<4>(msb_codec<4>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_five_bit_msb) {
+  test_encode_line_wrapping<5>(msb_codec<5>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_six_bit_msb) {
+  test_encode_line_wrapping<6>(msb_codec<6>());
+}
+
+BOOST_AUTO_TEST_CASE(encode_line_wrapping_seven_bit_msb) {
+  test_encode_line_wrapping<7>(msb_codec<7>());
+}
+
+// -----------------------------------------------------------------------------
+// A codec that sizes its output through adl, here without padding.
+namespace unpadded {
+struct base64 : msb_codec<6> {};
+
+std::size_t get_encoded_size(std::size_t source_size, base64 const&) {
+  return (source_size * 8 + 5) / 6;
+}
+} // namespace unpadded
+
+BOOST_AUTO_TEST_CASE(encoded_size_line_wrapping) {
+  boost::radix::line_wrapping const wrappings[] = {
+      boost::radix::line_wrapping(),
+      boost::radix::line_wrapping(1, boost::radix::line_terminator_lf),
+      boost::radix::line_wrapping(10, boost::radix::line_terminator_crlf),
+      boost::radix::line_wrapping::mime()};
+  BOOST_FOREACH(boost::radix::line_wrapping wrapping, wrappings) {
+    for(std::size_t size = 0; size < 300; ++size) {
+      BOOST_TEST(
+          wrapping.unwrapped_size(size + wrapping.wrapped_overhead(size)) ==
+          size);
+    }
+
+    unpadded::base64 codec;
+    for(std::size_t size = 0; size < 100; ++size) {
+      std::size_t const unwrapped = (size * 8 + 5) / 6;
+      BOOST_TEST(boost::radix::encoded_size(size, codec) == unwrapped);
+      BOOST_TEST(
+          boost::radix::encoded_size(size, codec, wrapping) ==
+          unwrapped + wrapping.wrapped_overhead(unwrapped));
+    }
+  }
+}
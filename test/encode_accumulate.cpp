@@ -0,0 +1,145 @@
+//
+// test/encode_accumulate.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestEncodeAccumulate
+#include <boost/test/unit_test.hpp>
+
+#include <boost/crc.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/crc32c.hpp>
+#include <boost/radix/encode.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+//
+BOOST_AUTO_TEST_CASE(crc32c_check_value) {
+  std::string const check = "123456789";
+  boost::radix::crc32c crc;
+  crc.process_bytes(check.data(), check.size());
+  BOOST_TEST(crc.checksum() == 0xE3069283u);
+
+  // Split at every point, including odd ones for the 8 byte steps.
+  std::vector<bits_type> data = generate_random_bytes(1000);
+  boost::radix::crc32c whole;
+  whole.process_bytes(data.data(), data.size());
+  for(std::size_t split = 0; split < data.size(); split += 37) {
+    boost::radix::crc32c parts;
+    parts.process_bytes(data.data(), split);
+    parts.process_bytes(data.data() + split, data.size() - split);
+    BOOST_TEST(parts.checksum() == whole.checksum());
+  }
+
+  whole.reset();
+  whole.process_bytes(check.data(), check.size());
+  BOOST_TEST(whole.checksum() == 0xE3069283u);
+}
+
+// Counts what it is given, to check every byte is seen once and in order.
+struct byte_recorder {
+  void process_bytes(void const* data, std::size_t size) {
+    bits_type const* bytes = static_cast<bits_type const*>(data);
+    seen.insert(seen.end(), bytes, bytes + size);
+    ++calls;
+  }
+
+  byte_recorder()
+      : calls(0) {
+  }
+
+  std::vector<bits_type> seen;
+  std::size_t calls;
+};
+
+// Contiguous input and a std::list take different paths through encode, and
+// both must pass every byte on once and in order.
+template <typename Codec>
+struct check_encode_recorded {
+  check_encode_recorded(
+      Codec const& codec,
+      std::vector<bits_type> const& data,
+      std::string const& expected)
+      : codec_(&codec)
+      , data_(&data)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::string encoded;
+    byte_recorder recorder;
+    std::size_t written = boost::radix::encode(
+        first, last, std::back_inserter(encoded), *codec_, recorder);
+    BOOST_TEST(written == expected_->size());
+    BOOST_TEST(encoded == *expected_);
+    BOOST_TEST(recorder.seen == *data_);
+  }
+
+  Codec const* codec_;
+  std::vector<bits_type> const* data_;
+  std::string const* expected_;
+};
+
+template <typename Codec>
+void test_encode_accumulate(Codec const& codec) {
+  for(std::size_t size = 0; size < 20000; size += 3331) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string expected;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(expected), codec);
+    boost::crc_32_type expected_crc;
+    expected_crc.process_bytes(data.data(), data.size());
+
+    std::string encoded;
+    boost::crc_32_type crc;
+    std::size_t written = boost::radix::encode(
+        data.data(), data.data() + data.size(), std::back_inserter(encoded),
+        codec, crc);
+    BOOST_TEST(written == expected.size());
+    BOOST_TEST(encoded == expected);
+    BOOST_TEST(crc.checksum() == expected_crc.checksum());
+
+    encoded.clear();
+    byte_recorder recorder;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec,
+        recorder);
+    BOOST_TEST(encoded == expected);
+    BOOST_TEST(recorder.seen == data);
+    BOOST_TEST(recorder.calls <= size / 256 + 1);
+
+    check_contiguous_and_listed(
+        data, check_encode_recorded<Codec>(codec, data, expected));
+
+    std::string wrapped;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(wrapped), codec,
+        boost::radix::line_wrapping::mime());
+    encoded.clear();
+    boost::radix::crc32c wrapped_crc;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec,
+        boost::radix::line_wrapping::mime(), wrapped_crc);
+    boost::radix::crc32c expected_crc32c;
+    expected_crc32c.process_bytes(data.data(), data.size());
+    BOOST_TEST(encoded == wrapped);
+    BOOST_TEST(wrapped_crc.checksum() == expected_crc32c.checksum());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(encode_accumulate_base32) {
+  test_encode_accumulate(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(encode_accumulate_base64) {
+  test_encode_accumulate(boost::radix::codec::rfc4648::base64());
+}
@@ -0,0 +1,95 @@
+//
+// test/find_encoded.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestFindEncoded
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/find_encoded.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Every result is checked against searching the decoded data. Bytes from a
+// small range make repeats common, so the earliest of several matches at
+// different offsets in a segment has to be picked.
+template <typename Codec>
+void check_find_encoded(
+    std::vector<bits_type> const& data,
+    std::string const& text,
+    std::vector<bits_type> const& needle,
+    Codec const& codec) {
+  std::vector<bits_type>::const_iterator found =
+      std::search(data.begin(), data.end(), needle.begin(), needle.end());
+
+  boost::optional<std::size_t> contiguous = boost::radix::find_encoded(
+      text.data(), text.data() + text.size(), needle.begin(), needle.end(),
+      codec);
+  boost::optional<std::size_t> iterated = boost::radix::find_encoded(
+      text.begin(), text.end(), needle.begin(), needle.end(), codec);
+  if(found == data.end()) {
+    BOOST_TEST(!contiguous);
+    BOOST_TEST(!iterated);
+  } else {
+    std::size_t const expected = found - data.begin();
+    BOOST_TEST((contiguous && *contiguous == expected));
+    BOOST_TEST((iterated && *iterated == expected));
+  }
+}
+
+template <typename Codec>
+void test_find_encoded(Codec const& codec) {
+  std::vector<bits_type> data = generate_random_bytes(40000, 7);
+  std::string text;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(text), codec);
+
+  for(std::size_t size = 1; size < 24; size += 2) {
+    for(std::size_t at = 0; at + size <= data.size(); at += 3011 + size) {
+      std::vector<bits_type> needle(
+          data.begin() + at, data.begin() + at + size);
+      check_find_encoded(data, text, needle, codec);
+      needle.back() = 0xff;
+      check_find_encoded(data, text, needle, codec);
+    }
+    std::vector<bits_type> tail(data.end() - size, data.end());
+    check_find_encoded(data, text, tail, codec);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(find_encoded_base16) {
+  test_find_encoded(boost::radix::codec::rfc4648::base16());
+}
+
+BOOST_AUTO_TEST_CASE(find_encoded_base32) {
+  test_find_encoded(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(find_encoded_base64) {
+  test_find_encoded(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(find_encoded_vectors) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string const text = "VGhlIHF1aWNrIGJyb3duIGZveA==";
+  std::string const needle = "brown";
+  boost::optional<std::size_t> found = boost::radix::find_encoded(
+      text.begin(), text.end(), needle.begin(), needle.end(), codec);
+  BOOST_TEST((found && *found == 10u));
+
+  std::string const missing = "browns";
+  BOOST_TEST(!boost::radix::find_encoded(
+      text.begin(), text.end(), missing.begin(), missing.end(), codec));
+}
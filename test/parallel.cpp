@@ -0,0 +1,231 @@
+//
+// test/parallel.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestParallel
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/parallel.hpp>
+#include <boost/radix/thread_pool.hpp>
+
+#include <boost/function.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+struct base64_mime : boost::radix::codec::rfc4648::base64 {};
+
+namespace boost { namespace radix { namespace codec_traits {
+template <>
+struct max_encoded_line_length<base64_mime> {
+  BOOST_STATIC_CONSTANT(std::size_t, value = 76);
+};
+
+template <>
+struct encoded_line_terminator<base64_mime> {
+  BOOST_STATIC_CONSTANT(line_terminator, value = line_terminator_crlf);
+};
+}}} // namespace boost::radix::codec_traits
+
+// -----------------------------------------------------------------------------
+//
+template <typename Codec>
+void test_parallel_encode(Codec const& codec, std::size_t size) {
+  std::vector<bits_type> data = generate_random_bytes(size);
+  std::string expected;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(expected), codec);
+
+  boost::radix::thread_pool pool(3);
+  std::string result(boost::radix::encoded_size(data.size(), codec), '\0');
+  std::size_t written = boost::radix::parallel_encode(
+      data.data(), data.data() + data.size(), &result[0], codec, pool, 100);
+  BOOST_TEST(written == expected.size());
+  BOOST_TEST(result == expected);
+
+  std::string unpooled(boost::radix::encoded_size(data.size(), codec), '\0');
+  written = boost::radix::parallel_encode(
+      data.data(), data.data() + data.size(), &unpooled[0], codec);
+  BOOST_TEST(written == expected.size());
+  BOOST_TEST(unpooled == expected);
+}
+
+template <typename Codec>
+void test_parallel_decode(Codec const& codec, std::size_t size) {
+  std::vector<bits_type> data = generate_random_bytes(size);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+  boost::radix::thread_pool pool(3);
+  std::vector<bits_type> result(
+      boost::radix::decoded_size(encoded.size(), codec));
+  std::size_t written = boost::radix::parallel_decode(
+      encoded.data(), encoded.data() + encoded.size(), result.data(), codec,
+      pool, 100);
+  result.resize(written);
+  BOOST_TEST(result == data);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_encode_base64) {
+  boost::radix::codec::rfc4648::base64 codec;
+  for(std::size_t size = 0; size < 700; size += 97)
+    test_parallel_encode(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_encode_base32) {
+  boost::radix::codec::rfc4648::base32 codec;
+  for(std::size_t size = 0; size < 700; size += 97)
+    test_parallel_encode(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_encode_line_breaks) {
+  base64_mime codec;
+  for(std::size_t size = 0; size < 2000; size += 57)
+    test_parallel_encode(codec, size);
+  for(std::size_t size = 1; size < 2000; size += 131)
+    test_parallel_encode(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decode_base64) {
+  boost::radix::codec::rfc4648::base64 codec;
+  for(std::size_t size = 0; size < 700; size += 97)
+    test_parallel_decode(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decode_base32) {
+  boost::radix::codec::rfc4648::base32 codec;
+  for(std::size_t size = 0; size < 700; size += 97)
+    test_parallel_decode(codec, size);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decode_error) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec);
+  encoded[2500] = '!';
+
+  boost::radix::thread_pool pool(3);
+  std::vector<bits_type> result(
+      boost::radix::decoded_size(encoded.size(), codec));
+  BOOST_CHECK_THROW(
+      boost::radix::parallel_decode(
+          encoded.data(), encoded.data() + encoded.size(), result.data(),
+          codec, pool, 100),
+      boost::radix::nonalphabet_character);
+}
+
+// Hands the first few functions to a pool and then fails, as an executor that
+// has run out of room would.
+struct failing_executor {
+  void execute(boost::function<void()> const& f) {
+    if(!accepted)
+      throw std::runtime_error("executor full");
+    --accepted;
+    pool.execute(f);
+  }
+
+  std::size_t size() const {
+    return pool.size();
+  }
+
+  boost::radix::thread_pool& pool;
+  std::size_t accepted;
+};
+
+BOOST_AUTO_TEST_CASE(parallel_executor_error) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string result(boost::radix::encoded_size(data.size(), codec), '\0');
+
+  // The workers that were posted must have finished with the chunks before
+  // the error reaches the caller.
+  boost::radix::thread_pool pool(3);
+  for(std::size_t accepted = 0; accepted < 3; ++accepted) {
+    failing_executor executor = {pool, accepted};
+    BOOST_CHECK_THROW(
+        boost::radix::parallel_encode(
+            data.data(), data.data() + data.size(), &result[0], codec,
+            executor, 100),
+        std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_inline_pool) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string expected;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(expected), codec);
+
+  // A pool with no threads gets no workers, and the calling thread encodes
+  // every chunk.
+  boost::radix::thread_pool pool(0);
+  std::string result(expected.size(), '\0');
+  std::size_t written = boost::radix::parallel_encode(
+      data.data(), data.data() + data.size(), &result[0], codec, pool, 100);
+  BOOST_TEST(written == expected.size());
+  BOOST_TEST(result == expected);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decode_skip_whitespace) {
+  boost::radix::codec::rfc4648::base64 codec;
+  for(std::size_t size = 0; size < 2000; size += 173) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec);
+
+    // Wrap as MIME does and sprinkle in some extra whitespace.
+    std::string wrapped;
+    for(std::size_t i = 0; i < encoded.size(); ++i) {
+      if(i && i % 76 == 0)
+        wrapped += "\r\n";
+      if(i % 37 == 5)
+        wrapped += ' ';
+      wrapped += encoded[i];
+    }
+    wrapped += "\r\n";
+
+    boost::radix::thread_pool pool(3);
+    std::size_t const chunk_sizes[] = {1, 7, 64, 100, 4096};
+    for(std::size_t i = 0; i < 5; ++i) {
+      std::vector<bits_type> result(
+          boost::radix::decoded_size(wrapped.size(), codec));
+      std::size_t written = boost::radix::parallel_decode_skip_whitespace(
+          wrapped.data(), wrapped.data() + wrapped.size(), result.data(), codec,
+          pool, chunk_sizes[i]);
+      result.resize(written);
+      BOOST_TEST(result == data);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decode_skip_whitespace_error) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string wrapped;
+  for(int i = 0; i < 64; ++i)
+    wrapped += "Zm9vYmFy\n";
+  wrapped[300] = '!';
+
+  boost::radix::thread_pool pool(3);
+  std::vector<bits_type> result(
+      boost::radix::decoded_size(wrapped.size(), codec));
+  BOOST_CHECK_THROW(
+      boost::radix::parallel_decode_skip_whitespace(
+          wrapped.data(), wrapped.data() + wrapped.size(), result.data(),
+          codec, pool, 64),
+      boost::radix::nonalphabet_character);
+}
@@ -0,0 +1,129 @@
+//
+// test/resume_encoder.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestResumeEncoder
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/resume_encoder.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Encoding the data in two parts, the second appended to the encoding of the
+// first, must give the same text as encoding it in one go.
+template <typename Codec>
+void test_append_encoded(
+    Codec const& codec, boost::radix::line_wrapping wrapping) {
+  std::vector<bits_type> data = generate_random_bytes(200);
+  std::string expected;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(expected), codec, wrapping);
+
+  for(std::size_t split = 0; split <= data.size(); split += 7) {
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.begin() + split, std::back_inserter(encoded), codec,
+        wrapping);
+    std::size_t kept = encoded.size();
+    std::size_t written = boost::radix::append_encoded(
+        encoded, data.begin() + split, data.end(), codec, wrapping);
+    BOOST_TEST(encoded == expected);
+    BOOST_TEST(written <= expected.size());
+    BOOST_TEST(written + std::min(kept, encoded.size()) >= expected.size());
+
+    // Appended in pieces, a byte at a time at the start.
+    encoded.clear();
+    for(std::size_t i = 0; i < split && i < 5; ++i)
+      boost::radix::append_encoded(
+          encoded, data.begin() + i, data.begin() + i + 1, codec, wrapping);
+    if(split > 5)
+      boost::radix::append_encoded(
+          encoded, data.begin() + 5, data.begin() + split, codec, wrapping);
+    boost::radix::append_encoded(
+        encoded, data.begin() + split, data.end(), codec, wrapping);
+    BOOST_TEST(encoded == expected);
+  }
+}
+
+template <typename Codec>
+void test_append_encoded(Codec const& codec) {
+  test_append_encoded(codec, boost::radix::line_wrapping());
+  test_append_encoded(codec, boost::radix::line_wrapping::mime());
+  test_append_encoded(codec, boost::radix::line_wrapping(10));
+}
+
+BOOST_AUTO_TEST_CASE(append_encoded_base16) {
+  test_append_encoded(boost::radix::codec::rfc4648::base16());
+}
+
+BOOST_AUTO_TEST_CASE(append_encoded_base32) {
+  test_append_encoded(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(append_encoded_base64) {
+  test_append_encoded(boost::radix::codec::rfc4648::base64());
+}
+
+// The encoder writes from the returned position, so it works on a list too
+// and stays put when the final segment is complete.
+BOOST_AUTO_TEST_CASE(resume_encoder) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string const text = "Zm9vYmE=";
+  std::list<char_type> listed(text.begin(), text.end());
+  std::string appended;
+  boost::radix::encoder<
+      boost::radix::codec::rfc4648::base64,
+      std::back_insert_iterator<std::string> >
+      e(codec, std::back_inserter(appended));
+  std::list<char_type>::iterator resume_point =
+      boost::radix::resume_encoder(e, listed.begin(), listed.end());
+  BOOST_TEST(std::distance(listed.begin(), resume_point) == 4);
+  bits_type const r = 'r';
+  e.append(&r, &r + 1);
+  e.resolve();
+  BOOST_TEST(appended == "YmFy");
+
+  std::string complete = "Zm9vYmFy\n";
+  appended.clear();
+  boost::radix::encoder<
+      boost::radix::codec::rfc4648::base64,
+      std::back_insert_iterator<std::string> >
+      f(codec, std::back_inserter(appended));
+  BOOST_TEST(
+      (boost::radix::resume_encoder(f, complete.begin(), complete.end()) ==
+       complete.end() - 1));
+}
+
+BOOST_AUTO_TEST_CASE(resume_encoder_errors) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data(1, 'a');
+  std::string text = "Zm9vY*==";
+  BOOST_CHECK_THROW(
+      boost::radix::append_encoded(text, data.begin(), data.end(), codec),
+      boost::radix::nonalphabet_character);
+  text = "Zm9vY=E=";
+  BOOST_CHECK_THROW(
+      boost::radix::append_encoded(text, data.begin(), data.end(), codec),
+      boost::radix::invalid_padding);
+  text = "Zm9vY===";
+  BOOST_CHECK_THROW(
+      boost::radix::append_encoded(text, data.begin(), data.end(), codec),
+      boost::radix::invalid_padding);
+  text = "Zm=";
+  BOOST_CHECK_THROW(
+      boost::radix::append_encoded(text, data.begin(), data.end(), codec),
+      boost::radix::invalid_padding);
+}
@@ -0,0 +1,210 @@
+//
+// test/rewrap.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestRewrap
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/rewrap.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Contiguous input over the block threshold is rewrapped a block at a time
+// and a std::list one character at a time, so both are checked against what
+// encode writes.
+template <typename Codec>
+std::string encode_string(
+    std::vector<bits_type> const& data,
+    Codec const& codec,
+    boost::radix::line_wrapping wrapping) {
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec, wrapping);
+  return encoded;
+}
+
+template <typename Codec>
+struct check_rewrap_result {
+  check_rewrap_result(
+      Codec const& codec,
+      boost::radix::line_wrapping wrapping,
+      std::string const& expected)
+      : codec_(&codec)
+      , wrapping_(wrapping)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::string result;
+    std::size_t written = boost::radix::rewrap(
+        first, last, std::back_inserter(result), *codec_, wrapping_);
+    BOOST_TEST(written == expected_->size());
+    BOOST_TEST(result == *expected_);
+  }
+
+  Codec const* codec_;
+  boost::radix::line_wrapping wrapping_;
+  std::string const* expected_;
+};
+
+template <typename Codec>
+void check_rewrap(
+    std::string const& input,
+    std::string const& expected,
+    Codec const& codec,
+    boost::radix::line_wrapping wrapping) {
+  check_contiguous_and_listed(
+      input, check_rewrap_result<Codec>(codec, wrapping, expected));
+}
+
+// Misplaced padding and final segments that can't be decoded throw, or with
+// an error code handler stop rewrapping with expected written.
+template <typename Codec>
+struct check_rewrap_padding_error {
+  check_rewrap_padding_error(Codec const& codec, std::string const& expected)
+      : codec_(&codec)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::string result;
+    BOOST_CHECK_THROW(
+        boost::radix::unwrap(first, last, std::back_inserter(result), *codec_),
+        boost::radix::invalid_padding);
+
+    boost::radix::decode_validation::error error =
+        boost::radix::decode_validation::none;
+    boost::radix::decode_error_handler_skip_whitespace_error_code<
+        boost::radix::decode_validation::error>
+        errh(*codec_, error);
+    result.clear();
+    std::size_t written = boost::radix::rewrap(
+        first, last, std::back_inserter(result), *codec_,
+        boost::radix::line_wrapping(), errh);
+    BOOST_TEST(error == boost::radix::decode_validation::invalid_padding);
+    BOOST_TEST(written == expected_->size());
+    BOOST_TEST(result == *expected_);
+  }
+
+  Codec const* codec_;
+  std::string const* expected_;
+};
+
+template <typename Codec>
+void check_rewrap_padding_errors(
+    Codec const& codec,
+    std::string const& input,
+    std::string const& expected) {
+  check_contiguous_and_listed(
+      input, check_rewrap_padding_error<Codec>(codec, expected));
+}
+
+template <typename Codec>
+void test_rewrap(Codec const& codec) {
+  boost::radix::line_wrapping const single_line;
+  boost::radix::line_wrapping const mime = boost::radix::line_wrapping::mime();
+  boost::radix::line_wrapping const pem  = boost::radix::line_wrapping::pem();
+  for(std::size_t size = 0; size < 5000; size += 367) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string const plain     = encode_string(data, codec, single_line);
+    std::string const mime_text = encode_string(data, codec, mime);
+    std::string const pem_text  = encode_string(data, codec, pem);
+
+    check_rewrap(mime_text, plain, codec, single_line);
+    check_rewrap(mime_text + "\r\n", plain, codec, single_line);
+    check_rewrap(plain, mime_text, codec, mime);
+    check_rewrap(pem_text, mime_text, codec, mime);
+    check_rewrap(mime_text, pem_text, codec, pem);
+
+    // Missing padding is put back.
+    std::string unpadded = plain.substr(0, plain.find(codec.get_pad_char()));
+    check_rewrap(unpadded, plain, codec, single_line);
+    check_rewrap(unpadded, mime_text, codec, mime);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rewrap_base64) {
+  test_rewrap(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(rewrap_base32) {
+  test_rewrap(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(unwrap) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::string const text = "Zm9v\r\nYmFy\n Zg";
+  std::string result;
+  boost::radix::unwrap(
+      text.begin(), text.end(), std::back_inserter(result), codec);
+  BOOST_TEST(result == "Zm9vYmFyZg==");
+}
+
+BOOST_AUTO_TEST_CASE(rewrap_errors) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string text =
+      encode_string(data, codec, boost::radix::line_wrapping::mime());
+  std::string result;
+
+  std::string bad = text;
+  bad[1500]       = '*';
+  BOOST_CHECK_THROW(
+      boost::radix::unwrap(
+          bad.data(), bad.data() + bad.size(), std::back_inserter(result),
+          codec),
+      boost::radix::nonalphabet_character);
+
+  bad[1500] = '=';
+  BOOST_CHECK_THROW(
+      boost::radix::unwrap(
+          bad.data(), bad.data() + bad.size(), std::back_inserter(result),
+          codec),
+      boost::radix::invalid_padding);
+
+  // A strict handler treats the line breaks as errors.
+  boost::radix::decode_validation::error error =
+      boost::radix::decode_validation::none;
+  boost::radix::decode_error_handler_error_code<
+      boost::radix::decode_validation::error>
+      errh(codec, error);
+  result.clear();
+  std::size_t written = boost::radix::rewrap(
+      text.data(), text.data() + text.size(), std::back_inserter(result),
+      codec, boost::radix::line_wrapping(), errh);
+  BOOST_TEST(error == boost::radix::decode_validation::invalid_whitespace);
+  BOOST_TEST(written == 76u);
+  BOOST_TEST(result == text.substr(0, 76));
+}
+
+BOOST_AUTO_TEST_CASE(rewrap_padding_errors) {
+  boost::radix::codec::rfc4648::base64 base64;
+  check_rewrap_padding_errors(base64, "Z", "Z");
+  check_rewrap_padding_errors(base64, "Zm9vZ", "Zm9vZ");
+  check_rewrap_padding_errors(base64, "Zg=", "Zg");
+  check_rewrap_padding_errors(base64, "Zg=====", "Zg");
+  check_rewrap_padding_errors(base64, "Zm9v====", "Zm9v");
+  check_rewrap_padding_errors(base64, "Zg==Zm9v", "Zg");
+
+  boost::radix::codec::rfc4648::base32 base32;
+  check_rewrap_padding_errors(base32, "MZXW6Y", "MZXW6Y");
+  check_rewrap_padding_errors(base32, "MZX=====", "MZX");
+
+  // A line break after the padding is still fine.
+  check_rewrap(
+      std::string("Zg==\r\n"), std::string("Zg=="), base64,
+      boost::radix::line_wrapping());
+}
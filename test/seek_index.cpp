@@ -0,0 +1,177 @@
+//
+// test/seek_index.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestSeekIndex
+#include <boost/test/unit_test.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/seek_index.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Whitespace of varying lengths scattered through the text, so no arithmetic
+// finds a segment.
+std::string scatter_whitespace(std::string const& text) {
+  std::string scattered;
+  for(std::size_t i = 0, gap = 1; i < text.size(); ++i) {
+    if(i % 57 == 0) {
+      scattered.append(gap, i % 2 ? ' ' : '\n');
+      gap = gap % 5 + 1;
+    }
+    scattered += text[i];
+  }
+  return scattered + "\r\n";
+}
+
+// Contiguous input is scanned a block at a time and a std::list one
+// character at a time, and both must place the checkpoints alike.
+template <typename Codec>
+struct check_same_checkpoints {
+  check_same_checkpoints(
+      Codec const& codec,
+      std::size_t interval,
+      boost::radix::seek_index const& expected)
+      : codec_(&codec)
+      , interval_(interval)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    boost::radix::seek_index index(first, last, *codec_, interval_);
+    BOOST_TEST(index.interval() == expected_->interval());
+    BOOST_TEST(index.symbols() == expected_->symbols());
+    BOOST_TEST(index.encoded_size() == expected_->encoded_size());
+    BOOST_TEST(index.size() == expected_->size());
+    for(std::size_t i = 0; i < index.size() && i < expected_->size(); ++i)
+      BOOST_TEST(index[i].encoded_offset == (*expected_)[i].encoded_offset);
+  }
+
+  Codec const* codec_;
+  std::size_t interval_;
+  boost::radix::seek_index const* expected_;
+};
+
+template <typename Codec>
+void test_seek_index(Codec const& codec, std::size_t interval) {
+  std::vector<bits_type> data = generate_random_bytes(40000);
+  std::string text;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(text), codec);
+  std::string const scattered = scatter_whitespace(text);
+
+  boost::radix::seek_index index(
+      scattered.data(), scattered.data() + scattered.size(), codec, interval);
+  std::size_t const packed =
+      boost::radix::codec_traits::packed_segment_size<Codec>::value;
+  std::size_t const unpacked =
+      boost::radix::codec_traits::unpacked_segment_size<Codec>::value;
+  std::size_t const per_checkpoint = index.interval() / packed * unpacked;
+  BOOST_TEST(index.interval() % packed == 0u);
+  BOOST_TEST(index.interval() >= interval);
+  BOOST_TEST(index.symbols() == text.size());
+  BOOST_TEST(index.encoded_size() == scattered.size());
+  BOOST_TEST(
+      index.size() == (text.size() + per_checkpoint - 1) / per_checkpoint);
+
+  // Decoding from any checkpoint gives the bytes from its decoded offset on.
+  check_contiguous_and_listed(
+      scattered, check_same_checkpoints<Codec>(codec, interval, index));
+  for(std::size_t i = 0; i < index.size(); ++i) {
+    boost::radix::seek_index::checkpoint c = index[i];
+    BOOST_TEST(c.decoded_offset == i * index.interval());
+    if(i % (index.size() / 16 + 1))
+      continue;
+
+    std::vector<bits_type> decoded;
+    boost::radix::decode_error_handler_skip_whitespace errh(codec);
+    boost::radix::decode(
+        scattered.begin() + c.encoded_offset, scattered.end(),
+        std::back_inserter(decoded), codec, errh);
+    BOOST_TEST(decoded.size() == data.size() - c.decoded_offset);
+    BOOST_TEST(std::equal(
+        decoded.begin(), decoded.end(), data.begin() + c.decoded_offset));
+  }
+
+  std::size_t const bounds[][2] = {
+      {0, 10}, {3, 3000}, {12345, 12350}, {39990, 40010}, {40000, 40001}};
+  for(std::size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); ++i) {
+    std::vector<bits_type> range;
+    std::size_t written = boost::radix::decode_range(
+        scattered.begin(), scattered.end(), bounds[i][0], bounds[i][1],
+        std::back_inserter(range), codec, index);
+    std::vector<bits_type> expected(
+        data.begin() + std::min(bounds[i][0], data.size()),
+        data.begin() + std::min(bounds[i][1], data.size()));
+    BOOST_TEST(written == expected.size());
+    BOOST_TEST(range == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(seek_index_base32) {
+  test_seek_index(boost::radix::codec::rfc4648::base32(), 1000);
+  test_seek_index(boost::radix::codec::rfc4648::base32(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(seek_index_base64) {
+  test_seek_index(boost::radix::codec::rfc4648::base64(), 4096);
+  test_seek_index(boost::radix::codec::rfc4648::base64(), 3);
+}
+
+// Round trips an index through an archive, as text and as binary.
+template <typename OArchive, typename IArchive>
+void test_seek_index_serialize() {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(10000);
+  std::string text;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(text), codec,
+      boost::radix::line_wrapping::mime());
+  boost::radix::seek_index index(text.begin(), text.end(), codec, 512);
+
+  std::stringstream archive;
+  {
+    OArchive out(archive);
+    out << index;
+  }
+  boost::radix::seek_index loaded;
+  {
+    IArchive in(archive);
+    in >> loaded;
+  }
+
+  BOOST_TEST(loaded.interval() == index.interval());
+  BOOST_TEST(loaded.symbols() == index.symbols());
+  BOOST_TEST(loaded.encoded_size() == index.encoded_size());
+  BOOST_TEST(loaded.size() == index.size());
+  for(std::size_t i = 0; i < index.size(); ++i)
+    BOOST_TEST(loaded[i].encoded_offset == index[i].encoded_offset);
+  BOOST_TEST(loaded.find(5000).decoded_offset == 9 * index.interval());
+}
+
+BOOST_AUTO_TEST_CASE(seek_index_serialize) {
+  test_seek_index_serialize<
+      boost::archive::text_oarchive, boost::archive::text_iarchive>();
+}
+
+BOOST_AUTO_TEST_CASE(seek_index_serialize_binary) {
+  test_seek_index_serialize<
+      boost::archive::binary_oarchive, boost::archive::binary_iarchive>();
+}
@@ -0,0 +1,210 @@
+//
+// test/transcode.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestTranscode
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base32hex.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/codec/rfc4648/base64url.hpp>
+#include <boost/radix/transcode.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+using namespace boost::radix::codec::rfc4648;
+
+// base64 packed LSB first, which can't be translated character for character
+// to or from the standard alphabet.
+struct base64_lsb : base64 {};
+
+namespace boost { namespace radix { namespace codec_traits {
+template <>
+struct segment_bit_order<base64_lsb> {
+  BOOST_STATIC_CONSTANT(bit_order, value = bit_order_lsb_first);
+};
+}}} // namespace boost::radix::codec_traits
+
+// -----------------------------------------------------------------------------
+// Contiguous input takes the translation or chunked path and a std::list the
+// generic one, and both must match a decode followed by an encode.
+template <typename FromCodec, typename ToCodec>
+struct check_transcode {
+  check_transcode(
+      FromCodec const& from, ToCodec const& to, std::string const& expected)
+      : from_(&from)
+      , to_(&to)
+      , expected_(&expected) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    std::string result;
+    std::size_t written = boost::radix::transcode(
+        first, last, std::back_inserter(result), *from_, *to_);
+    BOOST_TEST(written == expected_->size());
+    BOOST_TEST(result == *expected_);
+  }
+
+  FromCodec const* from_;
+  ToCodec const* to_;
+  std::string const* expected_;
+};
+
+template <typename FromCodec, typename ToCodec>
+void test_transcode(FromCodec const& from, ToCodec const& to) {
+  for(std::size_t size = 0; size < 10000; size += 641) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string source;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(source), from);
+    std::string expected;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(expected), to);
+
+    check_contiguous_and_listed(
+        source, check_transcode<FromCodec, ToCodec>(from, to, expected));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(transcode_base64_base64url) {
+  test_transcode(base64(), base64url());
+  test_transcode(base64url(), base64());
+}
+
+BOOST_AUTO_TEST_CASE(transcode_base32_base32hex) {
+  test_transcode(base32(), base32hex());
+}
+
+BOOST_AUTO_TEST_CASE(transcode_base64_base16) {
+  test_transcode(base64(), base16());
+  test_transcode(base16(), base64());
+}
+
+BOOST_AUTO_TEST_CASE(transcode_base32_base64) {
+  test_transcode(base32(), base64());
+}
+
+BOOST_AUTO_TEST_CASE(transcode_bit_order) {
+  bits_type const data[] = {0x01, 0x00, 0x00};
+  std::string encoded;
+  boost::radix::encode(
+      data, data + 3, std::back_inserter(encoded), base64_lsb());
+  BOOST_TEST(encoded == "BAAA");
+
+  test_transcode(base64_lsb(), base64());
+  test_transcode(base64(), base64_lsb());
+  test_transcode(base64_lsb(), base64url());
+}
+
+BOOST_AUTO_TEST_CASE(transcode_errors) {
+  std::vector<bits_type> data = generate_random_bytes(3000);
+  std::string source;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(source), base64());
+
+  std::string bad = source;
+  bad[1234]       = '*';
+  std::string result;
+  BOOST_CHECK_THROW(
+      boost::radix::transcode(
+          bad.data(), bad.data() + bad.size(), std::back_inserter(result),
+          base64(), base64url()),
+      boost::radix::nonalphabet_character);
+
+  bad[1234] = '\n';
+  BOOST_CHECK_THROW(
+      boost::radix::transcode(
+          bad.data(), bad.data() + bad.size(), std::back_inserter(result),
+          base64(), base16()),
+      boost::radix::invalid_whitespace);
+
+  // Wrapped input is fine with a handler that skips the line breaks.
+  std::string wrapped;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(wrapped), base64(),
+      boost::radix::line_wrapping::mime());
+  std::string expected;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(expected), base64url());
+  base64 from;
+  boost::radix::decode_error_handler_skip_whitespace errh(from);
+  result.clear();
+  boost::radix::transcode(
+      wrapped.data(), wrapped.data() + wrapped.size(),
+      std::back_inserter(result), from, base64url(), errh);
+  BOOST_TEST(result == expected);
+}
+
+// An aborting handler stops at the error, whichever chunk it is in, and the
+// output is the whole segments before it.
+BOOST_AUTO_TEST_CASE(transcode_error_code) {
+  std::vector<bits_type> data = generate_random_bytes(30000);
+  std::string source;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(source), base64());
+
+  std::size_t const offsets[] = {100, 102, 6000, 39000};
+  for(std::size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+    std::string bad = source;
+    bad[offsets[i]] = '*';
+    std::size_t const whole = offsets[i] / 4 * 3;
+
+    std::string expected;
+    boost::radix::encode(
+        data.begin(), data.begin() + whole, std::back_inserter(expected),
+        base32());
+    base64 from;
+    boost::radix::decode_validation::error error =
+        boost::radix::decode_validation::none;
+    boost::radix::decode_error_handler_error_code<
+        boost::radix::decode_validation::error>
+        errh(from, error);
+    std::string result;
+    boost::radix::transcode(
+        bad.data(), bad.data() + bad.size(), std::back_inserter(result), from,
+        base32(), errh);
+    BOOST_TEST(error == boost::radix::decode_validation::nonalphabet_character);
+    BOOST_TEST(result == expected);
+
+    expected.clear();
+    boost::radix::encode(
+        data.begin(), data.begin() + whole, std::back_inserter(expected),
+        base64url());
+    error = boost::radix::decode_validation::none;
+    result.clear();
+    boost::radix::transcode(
+        bad.data(), bad.data() + bad.size(), std::back_inserter(result), from,
+        base64url(), errh);
+    BOOST_TEST(error == boost::radix::decode_validation::nonalphabet_character);
+    BOOST_TEST(result == expected);
+  }
+}
+
+// The final segment is resolved, padding and all, when the error comes
+// straight after it.
+BOOST_AUTO_TEST_CASE(transcode_error_after_padding) {
+  std::string const source = "Zm9vZg==!";
+  base64 from;
+  boost::radix::decode_validation::error error =
+      boost::radix::decode_validation::none;
+  boost::radix::decode_error_handler_error_code<
+      boost::radix::decode_validation::error>
+      errh(from, error);
+  std::string result;
+  std::size_t written = boost::radix::transcode(
+      source.data(), source.data() + source.size(), std::back_inserter(result),
+      from, base32(), errh);
+  BOOST_TEST(error == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(result == "MZXW6ZQ=");
+  BOOST_TEST(written == result.size());
+}
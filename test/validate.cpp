@@ -0,0 +1,191 @@
+//
+// test/validate.cpp
+//
+// Copyright (c) Chris Glover, 2017-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define BOOST_TEST_MODULE TestValidate
+#include <boost/test/unit_test.hpp>
+
+#include <boost/radix/codec/rfc4648/base16.hpp>
+#include <boost/radix/codec/rfc4648/base32.hpp>
+#include <boost/radix/codec/rfc4648/base32hex.hpp>
+#include <boost/radix/codec/rfc4648/base64.hpp>
+#include <boost/radix/codec/rfc4648/base64url.hpp>
+#include <boost/radix/decode.hpp>
+#include <boost/radix/encode.hpp>
+#include <boost/radix/validate.hpp>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+// -----------------------------------------------------------------------------
+// Contiguous input over the block threshold takes the vectorised scan while a
+// std::list is checked one character at a time, so every case runs through
+// both.
+template <typename Codec>
+struct check_validate_result {
+  check_validate_result(
+      Codec const& codec,
+      boost::radix::decode_validation::error error,
+      std::size_t error_offset,
+      std::size_t decoded_size)
+      : codec_(&codec)
+      , error_(error)
+      , error_offset_(error_offset)
+      , decoded_size_(decoded_size) {
+  }
+
+  template <typename Iterator>
+  void operator()(Iterator first, Iterator last) const {
+    boost::radix::validation_result result =
+        boost::radix::validate(first, last, *codec_);
+    BOOST_TEST(result.error == error_);
+    BOOST_TEST(result.error_offset == error_offset_);
+    if(error_ == boost::radix::decode_validation::none)
+      BOOST_TEST(result.decoded_size == decoded_size_);
+  }
+
+  Codec const* codec_;
+  boost::radix::decode_validation::error error_;
+  std::size_t error_offset_;
+  std::size_t decoded_size_;
+};
+
+template <typename Codec>
+void check_validate(
+    std::string const& encoded,
+    Codec const& codec,
+    boost::radix::decode_validation::error error,
+    std::size_t error_offset) {
+  std::vector<bits_type> decoded;
+  if(error == boost::radix::decode_validation::none) {
+    boost::radix::decode(
+        encoded.begin(), encoded.end(), std::back_inserter(decoded), codec);
+  }
+
+  check_contiguous_and_listed(
+      encoded, check_validate_result<Codec>(
+                   codec, error, error_offset, decoded.size()));
+}
+
+template <typename Codec>
+void test_validate(Codec const& codec) {
+  for(std::size_t size = 0; size < 1200; size += 37) {
+    std::vector<bits_type> data = generate_random_bytes(size);
+    std::string encoded;
+    boost::radix::encode(
+        data.begin(), data.end(), std::back_inserter(encoded), codec);
+    check_validate(
+        encoded, codec, boost::radix::decode_validation::none, encoded.size());
+
+    if(encoded.empty())
+      continue;
+
+    // Truncated input is still decodable, just not a whole number of
+    // segments.
+    std::string truncated(encoded.begin(), encoded.end() - 1);
+    if(truncated[truncated.size() - 1] != '=') {
+      check_validate(
+          truncated, codec, boost::radix::decode_validation::none,
+          truncated.size());
+    }
+
+    std::size_t const bad_offset = (size * 7) % encoded.size();
+    std::string bad              = encoded;
+    bad[bad_offset]              = '*';
+    check_validate(
+        bad, codec, boost::radix::decode_validation::nonalphabet_character,
+        bad_offset);
+
+    bad[bad_offset] = '\n';
+    check_validate(
+        bad, codec, boost::radix::decode_validation::invalid_whitespace,
+        bad_offset);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(validate_base16) {
+  test_validate(boost::radix::codec::rfc4648::base16());
+}
+
+BOOST_AUTO_TEST_CASE(validate_base32) {
+  test_validate(boost::radix::codec::rfc4648::base32());
+}
+
+BOOST_AUTO_TEST_CASE(validate_base32hex) {
+  test_validate(boost::radix::codec::rfc4648::base32hex());
+}
+
+BOOST_AUTO_TEST_CASE(validate_base64) {
+  test_validate(boost::radix::codec::rfc4648::base64());
+}
+
+BOOST_AUTO_TEST_CASE(validate_base64url) {
+  test_validate(boost::radix::codec::rfc4648::base64url());
+}
+
+BOOST_AUTO_TEST_CASE(validate_padding) {
+  boost::radix::codec::rfc4648::base64 codec;
+  check_validate(
+      std::string("QQ=="), codec, boost::radix::decode_validation::none, 4);
+  check_validate(
+      std::string("QQ==QQ=="), codec,
+      boost::radix::decode_validation::invalid_padding, 4);
+  check_validate(
+      std::string("QQ=A"), codec,
+      boost::radix::decode_validation::invalid_padding, 3);
+  check_validate(
+      std::string("QQ======"), codec,
+      boost::radix::decode_validation::invalid_padding, 4);
+
+  // A pad in the middle of input long enough for the block scan.
+  std::string long_input(600, 'A');
+  long_input[301] = '=';
+  check_validate(
+      long_input, codec, boost::radix::decode_validation::invalid_padding, 302);
+}
+
+BOOST_AUTO_TEST_CASE(validate_skip_whitespace) {
+  boost::radix::codec::rfc4648::base64 codec;
+  std::vector<bits_type> data = generate_random_bytes(2000);
+  std::string encoded;
+  boost::radix::encode(
+      data.begin(), data.end(), std::back_inserter(encoded), codec,
+      boost::radix::line_wrapping::mime());
+  encoded += "\r\n";
+
+  boost::radix::decode_error_handler_skip_whitespace errh(codec);
+  boost::radix::validation_result result = boost::radix::validate(
+      encoded.data(), encoded.data() + encoded.size(), codec, errh);
+  BOOST_TEST(result.valid());
+  BOOST_TEST(result.error_offset == encoded.size());
+  BOOST_TEST(result.decoded_size == data.size());
+
+  encoded[1000] = '!';
+  BOOST_CHECK_THROW(
+      boost::radix::validate(
+          encoded.data(), encoded.data() + encoded.size(), codec, errh),
+      boost::radix::nonalphabet_character);
+
+  boost::radix::decode_validation::error errc;
+  boost::radix::decode_error_handler_skip_whitespace_error_code<
+      boost::radix::decode_validation::error>
+      errc_handler(codec, errc);
+  result = boost::radix::validate(
+      encoded.data(), encoded.data() + encoded.size(), codec, errc_handler);
+  BOOST_TEST(
+      result.error == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(result.error_offset == 1000);
+
+  std::string const short_input = "Zm9v\n!Zg==";
+  result = boost::radix::validate(
+      short_input.begin(), short_input.end(), codec, errc_handler);
+  BOOST_TEST(
+      result.error == boost::radix::decode_validation::nonalphabet_character);
+  BOOST_TEST(result.error_offset == 5);
+}